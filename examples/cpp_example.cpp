@@ -0,0 +1,42 @@
+// Leave DEBUG out of the binary entirely
+#define MINT_LOGGO_CXX_MIN_LEVEL MINT_LOGGO_LEVEL_INFO
+#include "mint_loggo.hpp"
+
+#include <cstdint>
+#include <string>
+
+const char *const cpp_logger = "cpp";
+
+enum class Color : uint8_t { Red = 1, Green = 2 };
+
+int main() {
+    Mint_Loggo_LogFormat format = {};
+    format.colors = true;
+    format.linebeg = const_cast<char*>("[LOG CPP]");
+    if (Mint_Loggo_CreateLogger(cpp_logger, &format, NULL) == -1) {
+        return 1;
+    }
+
+    std::string user = "mint";
+    int local = 0;
+
+    // Arguments are serialized into the queued message and formatted on the logger thread
+    mint::loggo::Info(cpp_logger, "hello {} you are {} years old", user, 7);
+    mint::loggo::Warn(cpp_logger, "pi is about {} and this is {}", 3.14159, true);
+    mint::loggo::Error(cpp_logger, "{{literal braces}} color {} at {}", Color::Green, &local);
+    mint::loggo::Debug(cpp_logger, "compiled out {}", 42);
+
+    // Checked at compile time on C++17 as well
+    MINT_LOGGO_CXX(MINT_LOGGO_LEVEL_FATAL, cpp_logger, "{} + {} = {}", 1, 2, 3u);
+    MINT_LOGGO_CXX(MINT_LOGGO_LEVEL_INFO, cpp_logger, "no arguments");
+
+    // Begins here and ends with the block, text loggers print spans as lines
+    {
+        mint::loggo::Span span(cpp_logger, "shutdown");
+        mint::loggo::Context phase("phase", "shutdown");
+        mint::loggo::Info(cpp_logger, "shutting down");
+    }
+
+    Mint_Loggo_DeleteLoggers();
+    return 0;
+}
@@ -0,0 +1,3 @@
+// The implementation is C, compile it once in a C translation unit
+#define MINT_LOGGO_IMPLEMENTATION
+#include "mint_loggo.h"
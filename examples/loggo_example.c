@@ -17,25 +17,64 @@
 // Loggers accessed by name
 const char *const stdout_logger = "stdout";
 const char *const file_logger = "file_logger";
+const char *const json_logger = "json";
+const char *const trace_logger = "trace";
+const char *const indexed_logger = "indexed";
+
+// Declared up front and registered in one call, neither gets a queue or thread until it logs
+static Mint_Loggo_LoggerDecl lazy_loggers[] = {
+    {.name = "net", .format = &(Mint_Loggo_LogFormat){.level=MINT_LOGGO_LEVEL_WARN, .linebeg="[LOG NET]"}},
+    {.name = "disk", .format = &(Mint_Loggo_LogFormat){.level=MINT_LOGGO_LEVEL_DEBUG, .linebeg="[LOG DISK]"}},
+    // Never gets a thread, main writes its messages out with Mint_Loggo_Poll
+    {.name = "loop", .format = &(Mint_Loggo_LogFormat){.level=MINT_LOGGO_LEVEL_DEBUG, .linebeg="[LOG LOOP]", .threadless=true}},
+};
 
 int main() {
     // Custom Format
     // NULL Handler defaults to stdout
+    // The logger thread spins for a while before parking and shows up as loggo-stdout in top/gdb
+    // Timestamps are cycle counter reads converted to microsecond wall clock time on the logger thread
     int32_t stdout_id = Mint_Loggo_CreateLogger(stdout_logger, 
-                            &(Mint_Loggo_LogFormat){.colors=true, .level=MINT_LOGGO_LEVEL_DEBUG, .flush=true, .linebeg="[LOG STDOUT]", .linesep="\n"},
+                            &(Mint_Loggo_LogFormat){.colors=true, .level=MINT_LOGGO_LEVEL_DEBUG, .flush=true, .linebeg="[LOG STDOUT]", .linesep="\n",
+                                                    .wait_strategy=MINT_LOGGO_WAIT_SPIN, .thread_name="loggo-stdout",
+                                                    .time_source=MINT_LOGGO_TIME_SOURCE_TSC, .time_precision=MINT_LOGGO_PRECISION_MICROS},
                             NULL);
 
     // WriteStream uses fputs
     // CloseStream uses fclose
     // FlushStream uses fflush
     // Obviously you can customize these by matching the expected function typedefs
+    // Messages come out of 256 preallocated slots instead of malloc
+    // Errors and up jump ahead of whatever is still queued
     FILE* file = fopen("mylog.txt", "w");
     int32_t file_id = Mint_Loggo_CreateLogger(file_logger, 
-                            &(Mint_Loggo_LogFormat){.colors=false, .level=MINT_LOGGO_LEVEL_DEBUG, .flush=true, .time_format="%Y-%M-%D", .linebeg="[LOG FILE]", .linesep="\n"},
+                            &(Mint_Loggo_LogFormat){.colors=false, .level=MINT_LOGGO_LEVEL_DEBUG, .flush=true, .time_format="%Y-%M-%D", .linebeg="[LOG FILE]", .linesep="\n",
+                                                    .pool_slots=256, .priority=MINT_LOGGO_PRIORITY_LANES},
                             &(Mint_Loggo_LogHandler){.handle=file, .write_handler=Mint_Loggo_StreamWrite, .close_handler=Mint_Loggo_StreamClose, .flush_handler=Mint_Loggo_StreamFlush});
 
+    // One JSON object per line, untrusted text is escaped so it cant forge entries
+    // Every line carries the thread id plus whatever context the calling thread has set
+    int32_t json_id = Mint_Loggo_CreateLogger(json_logger,
+                            &(Mint_Loggo_LogFormat){.level=MINT_LOGGO_LEVEL_DEBUG, .flush=true, .output=MINT_LOGGO_OUTPUT_JSON, .sanitize=MINT_LOGGO_SANITIZE_ESCAPE,
+                                                    .thread_id=true},
+                            NULL);
+
+    // Chrome trace events, open trace.json in about:tracing or ui.perfetto.dev
+    FILE* trace = fopen("trace.json", "w");
+    int32_t trace_id = Mint_Loggo_CreateLogger(trace_logger,
+                            &(Mint_Loggo_LogFormat){.level=MINT_LOGGO_LEVEL_DEBUG, .output=MINT_LOGGO_OUTPUT_TRACE, .time_source=MINT_LOGGO_TIME_SOURCE_TSC},
+                            &(Mint_Loggo_LogHandler){.handle=trace, .write_handler=Mint_Loggo_StreamWrite, .close_handler=Mint_Loggo_StreamClose, .flush_handler=Mint_Loggo_StreamFlush});
+
+    // Writes indexed.log plus indexed.log.idx, try ./build/bin/loggo_query -l ERROR indexed.log (BUILD_TOOLS=ON)
+    Mint_Loggo_FileSink* indexed = Mint_Loggo_FileOpen(&(Mint_Loggo_FileConfig){.path="indexed.log", .index_records=2});
+    int32_t indexed_id = Mint_Loggo_CreateLogger(indexed_logger,
+                            &(Mint_Loggo_LogFormat){.level=MINT_LOGGO_LEVEL_DEBUG, .linebeg="[LOG INDEXED]"},
+                            &(Mint_Loggo_LogHandler){.handle=indexed, .write_handler=Mint_Loggo_FileWrite, .close_handler=Mint_Loggo_FileClose, .flush_handler=Mint_Loggo_FileFlush});
+
+    int32_t registered = Mint_Loggo_RegisterLoggers(lazy_loggers, sizeof(lazy_loggers) / sizeof(lazy_loggers[0]));
+
     // This would happen if you failed to supply a handle to a handler that you specified for instance
-    if (stdout_id == -1 || file_id == -1) {
+    if (stdout_id == -1 || file_id == -1 || json_id == -1 || trace_id == -1 || indexed_id == -1 || registered == -1) {
         Mint_Loggo_DeleteLoggers();
         fprintf(stderr, "Could not init logger..... Exiting");
         exit(EXIT_FAILURE);
@@ -47,26 +86,77 @@ int main() {
     LOG_ERROR(stdout_logger, "Hello Error");
     LOG_FATAL(stdout_logger, "Hello Fatal");
 
+    // Change a running logger in place, the new colors apply after everything already queued
+    Mint_Loggo_SetColors(stdout_logger, false);
+    LOG_INFO(stdout_logger, "Colors off");
+    // Literals can be borrowed instead of copied, only a pointer and length are queued
+    LOG_STATIC_INFO(stdout_logger, "Borrowed literal");
+
     LOG_DEBUG(file_logger, "Hello Debug");
     LOG_INFO(file_logger, "Hello Info");
     LOG_WARN(file_logger, "Hello Warn");
     LOG_ERROR(file_logger, "Hello Error");
     LOG_FATAL(file_logger, "Hello Fatal");
 
+    LOG_DEBUG(indexed_logger, "Hello Debug");
+    LOG_INFO(indexed_logger, "Hello Info");
+    LOG_ERROR(indexed_logger, "Hello Error");
+    LOG_DEBUG(indexed_logger, "Bye Debug");
+
+    Mint_Loggo_ContextSet("request", "42");
+    LOG_INFO(json_logger, "GET /index.html \"curl\"\n[LOG FILE] forged entry");
+    Mint_Loggo_ContextClear();
+
+    // Children write through "json" and follow its level until they get their own
+    Mint_Loggo_CreateChild("json.http");
+    Mint_Loggo_CreateChild("json.http.router");
+    Mint_Loggo_SetLevel("json.http", MINT_LOGGO_LEVEL_WARN);
+    LOG_INFO("json.http.router", "filtered by json.http");
+    LOG_WARN("json.http.router", "no route for /favicon.ico");
+
+    // Filtered out so "net" stays idle, "disk" starts its thread here
+    LOG_DEBUG("net", "not started");
+    LOG_INFO("disk", "started on first use");
+
+    // An event loop would wait on Mint_Loggo_EventFd() with epoll/poll and call this when it fires
+    LOG_INFO("loop", "written by main");
+    Mint_Loggo_Poll(0U);
+
+    // Spans nest, TRACE_SCOPE ends its span when the block exits
+    TRACE_BEGIN(trace_logger, "startup");
+    {
+        TRACE_SCOPE(trace_logger, "load_config");
+        LOG_INFO(trace_logger, "config loaded");
+    }
+    TRACE_INSTANT(trace_logger, "ready");
+    TRACE_END(trace_logger, "startup");
+
     // Or
     Mint_Loggo_Log(file_logger, MINT_LOGGO_LEVEL_ERROR, "AHHHHH HELP");
 
     // Or
     char* msg = malloc(sizeof(char) * 128U);
     snprintf(msg, (sizeof(char) * 128U), "Custom Message 0x%8X", 0xDEADBEEF);
-    // Passing true in Log2 frees the msg object
+    // Passing true in Log2 hands msg over without a copy, the logger thread frees it (same as Mint_Loggo_LogMove)
     Mint_Loggo_Log2(file_logger, MINT_LOGGO_LEVEL_FATAL, msg, true);
     // LOG2_LEVEL also works
 
+    // Built with -DMINT_LOGGO_LATENCY_STATS every message is timed from submit to write
+    #ifdef MINT_LOGGO_LATENCY_STATS
+        // Reconfiguring waits until everything logged before it is written, so all of it is counted
+        Mint_Loggo_LatencySummary latency;
+        Mint_Loggo_SetColors(stdout_logger, false);
+        Mint_Loggo_GetLatency(stdout_logger, MINT_LOGGO_LATENCY_TOTAL, &latency);
+        printf("%llu messages, p99 %llu ns submit to write\n", (unsigned long long)latency.count, (unsigned long long)latency.p99_ns);
+    #endif
+
     // Delete one logger
     Mint_Loggo_DeleteLogger(file_logger); 
 
     // Call at end of program to delete all loggers and clean up
     Mint_Loggo_DeleteLoggers();
+
+    // Sinks are owned by the caller, closing writes the last index entry
+    Mint_Loggo_FileClose(indexed);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,83 @@
+// Ship logs to a local agent over a unix socket
+#define MINT_LOGGO_USE_HELPERS
+#define MINT_LOGGO_IMPLEMENTATION
+#include "mint_loggo.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+const char *const socket_logger = "socket";
+const char *const socket_path = "/tmp/mint_loggo_example.sock";
+static int agent_conn = -1;
+
+
+// Pretend to be the agent, accept one connection and echo what it receives
+static void* Agent(void* arg) {
+    int listener = *(int*)arg;
+    agent_conn = accept(listener, NULL, NULL);
+    char buffer[4096];
+    ssize_t got = 0;
+    while ((got = read(agent_conn, buffer, sizeof(buffer))) > 0) {
+        printf("[agent got %zd bytes]\n%.*s", got, (int)got, buffer);
+    }
+    close(agent_conn);
+    return NULL;
+}
+
+
+static int Listen() {
+    struct sockaddr_un address = {.sun_family = AF_UNIX};
+    strcpy(address.sun_path, socket_path);
+    unlink(socket_path);
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    bind(listener, (struct sockaddr*)&address, sizeof(address));
+    listen(listener, 1);
+    return listener;
+}
+
+
+int main() {
+    int listener = Listen();
+    pthread_t agent;
+    pthread_create(&agent, NULL, Agent, &listener);
+
+    Mint_Loggo_SocketSink* sink = Mint_Loggo_SocketOpen(&(Mint_Loggo_SocketConfig){.path=socket_path, .reconnect_ms=10});
+    int32_t socket_id = Mint_Loggo_CreateLogger(socket_logger,
+                            &(Mint_Loggo_LogFormat){.level=MINT_LOGGO_LEVEL_DEBUG, .linebeg="[LOG SOCKET]"},
+                            &(Mint_Loggo_LogHandler){.handle=sink, .write_handler=Mint_Loggo_SocketWrite, .close_handler=Mint_Loggo_SocketClose, .flush_handler=Mint_Loggo_SocketFlush});
+
+    if (!sink || socket_id == -1) {
+        Mint_Loggo_DeleteLoggers();
+        fprintf(stderr, "Could not init logger..... Exiting");
+        exit(EXIT_FAILURE);
+    }
+
+    // These are batched together and sent when the logger goes idle
+    for (int idx = 0; idx < 5; idx++) {
+        LOG_INFO(socket_logger, "Hello Agent");
+    }
+    usleep(100000);
+
+    // Agent restarts, messages are buffered until the sink reconnects
+    shutdown(agent_conn, SHUT_RDWR);
+    pthread_join(agent, NULL);
+    close(listener);
+    LOG_WARN(socket_logger, "Agent is gone");
+    listener = Listen();
+    pthread_create(&agent, NULL, Agent, &listener);
+    usleep(100000);
+    LOG_INFO(socket_logger, "Agent is back");
+
+    // Sinks are owned by the caller, close after the logger is gone
+    Mint_Loggo_DeleteLoggers();
+    printf("dropped %llu\n", (unsigned long long)Mint_Loggo_SocketDropped(sink));
+    Mint_Loggo_SocketClose(sink);
+
+    pthread_join(agent, NULL);
+    close(listener);
+    unlink(socket_path);
+    return 0;
+}
@@ -1,6 +1,11 @@
 #ifndef MINT_LOGGO_H
 #define MINT_LOGGO_H
 
+// CPU_SET needs this, it only works when this header is the first include of the implementation file
+#if defined(MINT_LOGGO_IMPLEMENTATION) && defined(__linux__) && !defined(_GNU_SOURCE)
+    #define _GNU_SOURCE
+#endif
+
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -30,20 +35,27 @@
 
 #if defined(__unix__) || defined(linux) || defined(__APPLE__) || defined(MINT_LOGGO_USE_POSIX)
     #include <pthread.h>
+    #include <sched.h>
     #include <unistd.h>
     #define MINT_LOGGO_THREAD_TYPE pthread_t
     #define MINT_LOGGO_THREAD_CREATE(id, func, param) pthread_create((id), NULL, (func), (param))
     #define MINT_LOGGO_THREAD_JOIN(id) pthread_join((id), (NULL))
     #define MINT_LOGGO_MUTEX_TYPE pthread_mutex_t
+    #define MINT_LOGGO_MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
     #define MINT_LOGGO_MUTEX_INIT(mutex) pthread_mutex_init(&(mutex), NULL)
     #define MINT_LOGGO_MUTEX_DESTROY(mutex) pthread_mutex_destroy(&(mutex))
     #define MINT_LOGGO_MUTEX_LOCK(mutex) pthread_mutex_lock(&(mutex))
     #define MINT_LOGGO_MUTEX_UNLOCK(mutex) pthread_mutex_unlock(&(mutex))
     #define MINT_LOGGO_COND_TYPE pthread_cond_t
+    #define MINT_LOGGO_COND_INITIALIZER PTHREAD_COND_INITIALIZER
     #define MINT_LOGGO_COND_INIT(condition) pthread_cond_init(&(condition), NULL)
     #define MINT_LOGGO_COND_DESTROY(condition) pthread_cond_destroy(&(condition))
     #define MINT_LOGGO_COND_WAIT(condition, mutex) pthread_cond_wait(&(condition), &(mutex))
     #define MINT_LOGGO_COND_SIGNAL(condition) pthread_cond_signal(&(condition))
+    #define MINT_LOGGO_COND_BROADCAST(condition) pthread_cond_broadcast(&(condition))
+    #define MINT_LOGGO_THREAD_YIELD() sched_yield()
+    #define MINT_LOGGO_THREAD_DETACH(id) pthread_detach((id))
+    #define MINT_LOGGO_SLEEP_MS(ms) usleep((ms) * 1000U)
 #elif defined(_WIN32) || defined(MINT_LOGGO_USE_WINDOWS)
     #include <io.h>
     #include <Windows.h>
@@ -51,21 +63,70 @@
     #define MINT_LOGGO_THREAD_CREATE(id, func, param) CreateThread(NULL, 0, func, param, 0, id)
     #define MINT_LOGGO_THREAD_JOIN(id) WaitForSingleObject((id), INFINITE)
     #define MINT_LOGGO_MUTEX_TYPE LPCRITICAL_SECTION
+    #define MINT_LOGGO_MUTEX_INITIALIZER NULL
     #define MINT_LOGGO_MUTEX_INIT(mutex) InitializeCriticalSection((mutex))
     #define MINT_LOGGO_MUTEX_DESTROY(mutex) DeleteCriticalSection((mutex))
     #define MINT_LOGGO_MUTEX_LOCK(mutex) EnterCriticalSection((mutex))
     #define MINT_LOGGO_MUTEX_UNLOCK(mutex) LeaveCriticalSection((mutex))
     #define MINT_LOGGO_COND_TYPE PCONDITION_VARIABLE
+    #define MINT_LOGGO_COND_INITIALIZER NULL
     #define MINT_LOGGO_COND_INIT(condition) InitializeConditionVariable((condition))
     #define MINT_LOGGO_COND_DESTROY(condition) DeleteConditionVariable((condition))
     #define MINT_LOGGO_COND_WAIT(condition, mutex) SleepConditionVariableCS((condition), (mutex), INFINITE)
     #define MINT_LOGGO_COND_SIGNAL(condition) WakeConditionVariable((condition))
+    #define MINT_LOGGO_COND_BROADCAST(condition) WakeAllConditionVariable((condition))
+    #define MINT_LOGGO_THREAD_YIELD() SwitchToThread()
+    #define MINT_LOGGO_THREAD_DETACH(id) CloseHandle((id))
+    #define MINT_LOGGO_SLEEP_MS(ms) Sleep((ms))
+#endif
+
+// Atomics for the few values read outside of the queue lock
+#if defined(__GNUC__) || defined(__clang__)
+    #define MINT_LOGGO_ATOMIC_LOAD(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+    #define MINT_LOGGO_ATOMIC_STORE(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+    #define MINT_LOGGO_ATOMIC_CAS(ptr, expected, desired) __sync_bool_compare_and_swap((ptr), (expected), (desired))
+    #define MINT_LOGGO_ATOMIC_ADD(ptr, value) __sync_add_and_fetch((ptr), (value))
+#elif defined(_MSC_VER)
+    // Aligned word access is atomic on x86/x64 and MSVC wont reorder around it with /volatile:ms
+    #define MINT_LOGGO_ATOMIC_LOAD(ptr) (*(ptr))
+    #define MINT_LOGGO_ATOMIC_STORE(ptr, value) (*(ptr) = (value))
+    #define MINT_LOGGO_ATOMIC_CAS(ptr, expected, desired) (_InterlockedCompareExchange((volatile long*)(ptr), (long)(desired), (long)(expected)) == (long)(expected))
+    #define MINT_LOGGO_ATOMIC_ADD(ptr, value) (_InterlockedExchangeAdd((volatile long*)(ptr), (long)(value)) + (long)(value))
+#endif
+
+// Cheap hint for spin loops
+#if defined(__x86_64__) || defined(__i386__)
+    #define MINT_LOGGO_CPU_RELAX() __builtin_ia32_pause()
+#elif defined(_M_X64) || defined(_M_IX86)
+    #define MINT_LOGGO_CPU_RELAX() YieldProcessor()
+#elif defined(__aarch64__) || defined(__arm__)
+    #define MINT_LOGGO_CPU_RELAX() __asm__ __volatile__("yield")
+#else
+    #define MINT_LOGGO_CPU_RELAX() ((void)0)
 #endif
 
 #ifdef MINT__DEBUG
     #include <assert.h>
 #endif
 
+// Define MINT_LOGGO_NO_SIMD in the implementation file to scan messages a byte at a time whatever the target
+#if defined(MINT_LOGGO_IMPLEMENTATION) && !defined(MINT_LOGGO_NO_SIMD)
+    #if defined(__AVX2__)
+        #include <immintrin.h>
+    #elif defined(__SSE2__) || defined(_M_X64)
+        #include <emmintrin.h>
+    #endif
+#endif
+
+#if defined(MINT_LOGGO_IMPLEMENTATION)
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #elif defined(__x86_64__) || defined(__i386__)
+        #include <x86intrin.h>
+        #include <cpuid.h>
+    #endif
+#endif
+
 #define MINT_LOGGO_UNUSED(x) (void)(x)
 
 // Change this to change how Loggo is compiled in
@@ -89,17 +150,94 @@ typedef enum {
     MINT_LOGGO_LEVEL_FATAL
 } Mint_Loggo_LogLevel;
 
+// How the logger thread waits on an empty queue
+// BLOCK parks on the condition right away (default)
+// SPIN spins spin_count times, yields yield_count times, then parks
+// BUSY_POLL never parks, it burns a core for the lowest wake latency
+typedef enum {
+    MINT_LOGGO_WAIT_BLOCK,
+    MINT_LOGGO_WAIT_SPIN,
+    MINT_LOGGO_WAIT_BUSY_POLL
+} Mint_Loggo_WaitStrategy;
+
+// Line layout, JSON ignores colors and linebeg and always escapes the message
+// TRACE writes a Chrome trace-event JSON array (about:tracing, Perfetto), log lines become instant events
+typedef enum {
+    MINT_LOGGO_OUTPUT_TEXT,
+    MINT_LOGGO_OUTPUT_JSON,
+    MINT_LOGGO_OUTPUT_TRACE
+} Mint_Loggo_OutputFormat;
+
+// What to do with control characters, quotes and backslashes in untrusted messages
+// ESCAPE turns them into \n, \", \\, \x1b (\u001b in JSON), STRIP drops control characters
+typedef enum {
+    MINT_LOGGO_SANITIZE_NONE,
+    MINT_LOGGO_SANITIZE_ESCAPE,
+    MINT_LOGGO_SANITIZE_STRIP
+} Mint_Loggo_Sanitize;
+
+// Where timestamps come from
+// TIME is time(NULL), CLOCK is clock_gettime(CLOCK_REALTIME)
+// TSC reads the cycle counter on the calling thread and converts it to wall clock time on the logger thread,
+// it falls back to CLOCK when the counter is not invariant
+typedef enum {
+    MINT_LOGGO_TIME_SOURCE_TIME,
+    MINT_LOGGO_TIME_SOURCE_CLOCK,
+    MINT_LOGGO_TIME_SOURCE_TSC
+} Mint_Loggo_TimeSource;
+
+// Fraction printed after the time_format output
+typedef enum {
+    MINT_LOGGO_PRECISION_SECONDS,
+    MINT_LOGGO_PRECISION_MILLIS,
+    MINT_LOGGO_PRECISION_MICROS,
+    MINT_LOGGO_PRECISION_NANOS
+} Mint_Loggo_TimePrecision;
+
 typedef int (*CloseHandler)(void*);
 typedef int (*WriteHandler)(char*, void*);
 typedef int (*FlushHandler)(void*);
+typedef int (*WriteLenHandler)(const char*, size_t, void*);
+
+// One piece of a line for vectored writes
+typedef struct {
+    const char* data;
+    size_t len;
+} Mint_Loggo_IoVec;
+
+typedef int (*WriteVecHandler)(const Mint_Loggo_IoVec*, int, void*);
 
+// Called on the logger thread right before a record is written, with its wall clock time in nanoseconds
+typedef void (*RecordHandler)(Mint_Loggo_LogLevel, uint64_t, void*);
+
+// Where logging memory comes from, ctx is handed back on every call
+typedef struct {
+    void* (*alloc)(size_t size, void* ctx);
+    void* (*realloc)(void* ptr, size_t size, void* ctx);
+    void (*free)(void* ptr, void* ctx);
+    void* ctx;
+} Mint_Loggo_Allocator;
+
+// write_len_handler is optional, when set whole lines are written with a known length
+// write_vec_handler is optional, when set adopted Log2 buffers are written in place next to their prefix
+// record_handler is optional, it lets a sink see record boundaries (see the file sink index)
 typedef struct {
     void* handle;
     CloseHandler close_handler;
     WriteHandler write_handler;
     FlushHandler flush_handler;
+    WriteLenHandler write_len_handler;
+    WriteVecHandler write_vec_handler;
+    RecordHandler record_handler;
 } Mint_Loggo_LogHandler;
 
+// How urgent messages (urgent_level and up) are ordered against the rest
+typedef enum {
+    MINT_LOGGO_PRIORITY_FIFO,       // One lane, everything in call order
+    MINT_LOGGO_PRIORITY_LANES,      // The urgent lane is drained before the bulk lane, each lane keeps its order
+    MINT_LOGGO_PRIORITY_SYNC        // Urgent messages are written and flushed on the calling thread
+} Mint_Loggo_Priority;
+
 // The user controls the format
 typedef struct {
     Mint_Loggo_LogLevel level;
@@ -109,8 +247,135 @@ typedef struct {
     char* time_format;
     char* linesep;
     char* linebeg;
+    Mint_Loggo_WaitStrategy wait_strategy;
+    uint32_t spin_count;
+    uint32_t yield_count;
+    uint64_t cpu_affinity;      // Bit mask of cpus for the logger thread, 0 leaves it alone
+    const char* thread_name;    // NULL leaves the name alone
+    Mint_Loggo_OutputFormat output;
+    Mint_Loggo_Sanitize sanitize;
+    Mint_Loggo_TimeSource time_source;
+    Mint_Loggo_TimePrecision time_precision;
+    bool lazy;                  // Create the queue and thread on the first message that passes the level
+    const Mint_Loggo_Allocator* allocator;  // Messages for this logger, NULL uses the global allocator, copied at create but ctx must outlive the logger
+    uint32_t pool_slots;        // Preallocated message slots, 0 allocates every message
+    uint32_t pool_slot_size;    // Bytes per slot including the message header, 0 uses the default
+    Mint_Loggo_Priority priority;
+    Mint_Loggo_LogLevel urgent_level;   // DEBUG (the zero value) means ERROR, everything being urgent would be pointless
+    uint32_t urgent_capacity;   // 0 uses the default
+    bool thread_id;             // Put the calling thread's id on every line, context fields are always shown
+    bool threadless;            // No logger thread, the application writes queued messages with Mint_Loggo_Poll
+    bool fork_lazy;             // A forked child starts this logger's thread on its first message instead of right away
 } Mint_Loggo_LogFormat;
 
+// What a sink does when it cannot keep up with the logger
+typedef enum {
+    MINT_LOGGO_OVERFLOW_BLOCK,
+    MINT_LOGGO_OVERFLOW_DROP_NEWEST,
+    MINT_LOGGO_OVERFLOW_DROP_OLDEST
+} Mint_Loggo_OverflowPolicy;
+
+// One entry of a statically declared logger table, see Mint_Loggo_RegisterLoggers
+typedef struct {
+    const char* name;
+    Mint_Loggo_LogFormat* format;
+    Mint_Loggo_LogHandler* handler;
+} Mint_Loggo_LoggerDecl;
+
+// Unix domain socket sink settings, zero values use the defaults
+typedef struct {
+    const char* path;
+    bool datagram;
+    uint32_t frame_size;
+    uint32_t buffer_size;
+    uint32_t reconnect_ms;
+    Mint_Loggo_OverflowPolicy overflow;
+} Mint_Loggo_SocketConfig;
+
+// Opaque socket sink, pass it as the handle of a Mint_Loggo_LogHandler
+typedef struct Mint_Loggo_SocketSink Mint_Loggo_SocketSink;
+
+// How the file sink lays out the log
+// LZ packs records into blocks that are compressed on the logger thread and written as independent frames
+typedef enum {
+    MINT_LOGGO_COMPRESSION_NONE,
+    MINT_LOGGO_COMPRESSION_LZ
+} Mint_Loggo_Compression;
+
+// File sink settings, zero values use the defaults
+typedef struct {
+    const char* path;
+    const char* index_path;     // NULL puts the index next to the log as "<path>.idx"
+    bool append;
+    bool no_index;
+    uint32_t index_records;     // A chunk is closed after this many records
+    uint32_t index_bytes;       // or once it holds this many bytes, compressed logs close one chunk per block instead
+    Mint_Loggo_Compression compression;
+    uint32_t block_size;        // Uncompressed bytes per frame
+    bool per_process;           // A forked child switches to "<path>.<pid>" with its own index
+} Mint_Loggo_FileConfig;
+
+// Opaque file sink, pass it as the handle of a Mint_Loggo_LogHandler
+typedef struct Mint_Loggo_FileSink Mint_Loggo_FileSink;
+
+// The sidecar index is MINT_LOGGO_INDEX_MAGIC followed by one entry per chunk of the log file
+// Chunks start and end on record boundaries, the timestamps are the lowest and highest in the chunk
+#define MINT_LOGGO_INDEX_MAGIC "MLOGIDX1"
+
+// Compressed logs are a run of frames, each one a header followed by stored_len bytes
+// Frames decode on their own so a crash loses at most the block that was being filled
+#define MINT_LOGGO_FRAME_MAGIC 0x315A4C4DU     // "MLZ1" little endian
+#define MINT_LOGGO_FRAME_STORED 1U             // The block did not compress and is stored as is
+typedef struct {
+    uint32_t magic;
+    uint32_t raw_len;
+    uint32_t stored_len;
+    uint32_t flags;
+} Mint_Loggo_FrameHeader;
+typedef struct {
+    uint64_t offset;
+    uint64_t length;
+    uint64_t first_ns;
+    uint64_t last_ns;
+    uint32_t records;
+    uint32_t counts[MINT_LOGGO_LEVEL_FATAL + 2];    // Records per level, the last one counts unknown levels
+} Mint_Loggo_IndexEntry;
+
+// Renders a deferred payload on the logger thread
+// Works like snprintf, returns the length it needs even if that doesnt fit in capacity
+typedef size_t (*Mint_Loggo_FormatFn)(const void* payload, char* out, size_t capacity);
+
+// A reserved message, write the payload then commit it
+// payload is NULL when the level is filtered out and there is nothing to commit
+typedef struct {
+    void* payload;
+    void* message;
+    void* logger;
+} Mint_Loggo_Deferred;
+
+// Only there with MINT_LOGGO_LATENCY_STATS, see Mint_Loggo_GetLatency
+#ifdef MINT_LOGGO_LATENCY_STATS
+typedef enum {
+    MINT_LOGGO_LATENCY_QUEUE,       // Submitted until a writer took it off the queue
+    MINT_LOGGO_LATENCY_FORMAT,      // Taken until the line was laid out
+    MINT_LOGGO_LATENCY_WRITE,       // The sink's write, and flush when flush is set
+    MINT_LOGGO_LATENCY_TOTAL,       // Submitted until written
+    MINT_LOGGO_LATENCY_STAGES
+} Mint_Loggo_LatencyStage;
+
+// Percentiles are the top of their bucket, never more than max_ns
+typedef struct {
+    uint64_t count;
+    uint64_t min_ns;
+    uint64_t mean_ns;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t max_ns;
+} Mint_Loggo_LatencySummary;
+#endif
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -129,9 +394,40 @@ extern "C" {
 MINT_LOGGO_DEF int32_t Mint_Loggo_CreateLogger(const char* name, Mint_Loggo_LogFormat* user_format, Mint_Loggo_LogHandler* user_handler);
 
 
+/*
+ * Create a logger under its nearest dotted ancestor, "db.pool.conn" goes under "db.pool" or else "db".
+ * A child has no queue, thread or sink of its own, it writes through the first ancestor that does
+ * in that ancestor's format. Its level follows the ancestor until SetLevel gives it one.
+ * Deleting or recreating the ancestor that owns the thread deletes its children with it.
+ * Returns logger id on success or -1 when no ancestor exists
+ */
+MINT_LOGGO_DEF int32_t Mint_Loggo_CreateChild(const char* name);
+
+
+/*
+ * Register a table of loggers in one call, the table is sized once up front.
+ * Registered loggers always start lazily so an idle one is just a table entry.
+ * A name that is already in use or appears twice in the table fails the call before anything is created.
+ * Returns 0 on success, on failure none of the loggers in the table are kept and -1 is returned
+ */
+MINT_LOGGO_DEF int32_t Mint_Loggo_RegisterLoggers(const Mint_Loggo_LoggerDecl* loggers, size_t count);
+
+
+/*
+ * Route all of the library's memory through allocator, NULL goes back to malloc/realloc/free.
+ * Set it before creating any logger, memory is always returned to the allocator it came from
+ * A logger can still override it for its messages with Mint_Loggo_LogFormat.allocator
+ */
+MINT_LOGGO_DEF void Mint_Loggo_SetAllocator(const Mint_Loggo_Allocator* allocator);
+
+
 /* 
  * Delete logger waiting for all of its messages,
  * This will also clean up the resources if its the last logger so there is no need to call DeleteLoggers
+ * Loggers can be created and deleted while other threads log to other loggers, a deleted logger's
+ * struct (not its queue or sink) is kept until no lookup can still be reading it, up to
+ * MINT_LOGGO_HT_RETIRED_MAX of them are batched before they are freed
+ * The wait for its thread doesnt hold up creates and deletes of other loggers
  */
 MINT_LOGGO_DEF void Mint_Loggo_DeleteLogger(const char* name);
 
@@ -143,6 +439,79 @@ MINT_LOGGO_DEF void Mint_Loggo_DeleteLogger(const char* name);
  MINT_LOGGO_DEF void Mint_Loggo_DeleteLoggers();
 
 
+/*
+ * Stop every logger at once and let them drain side by side.
+ * deadline_ms of 0 waits for everything, otherwise loggers still draining at the deadline
+ * drop what is left in their queue. A logger stuck inside its sink is detached and leaked
+ * rather than freed from under it.
+ * Returns the number of messages that were dropped
+ */
+MINT_LOGGO_DEF uint64_t Mint_Loggo_Shutdown(uint32_t deadline_ms);
+
+
+/*
+ * Change a logger while it runs, the thread and its queue are kept and nothing queued is lost.
+ * Level applies to the next message logged, flush to the next one the logger thread writes.
+ * A level also reaches every dotted descendant that has not set its own, InheritLevel drops
+ * a logger's own level so it follows its nearest ancestor again.
+ * Colors and the handler are picked up by the logger thread once everything logged before the call
+ * is written, the old sink is flushed first. When SetHandler returns the old handle is no longer
+ * touched so the caller can close it, user_handler follows the same rules as in CreateLogger.
+ * Children only take a level, they have no sink of their own.
+ * Returns false for an unknown logger or a handler without a handle, or when the logger is deleted
+ * before the change is made, the new handler is closed then
+ */
+MINT_LOGGO_DEF bool Mint_Loggo_SetLevel(const char* name, Mint_Loggo_LogLevel level);
+MINT_LOGGO_DEF bool Mint_Loggo_InheritLevel(const char* name);
+MINT_LOGGO_DEF bool Mint_Loggo_SetFlush(const char* name, bool flush);
+MINT_LOGGO_DEF bool Mint_Loggo_SetColors(const char* name, bool colors);
+MINT_LOGGO_DEF bool Mint_Loggo_SetHandler(const char* name, Mint_Loggo_LogHandler* user_handler);
+
+
+/*
+ * Threadless loggers are drained from the application's own loop instead of a logger thread.
+ * The descriptor from Mint_Loggo_EventFd becomes readable when a threadless logger has messages,
+ * add it to epoll/poll and call Mint_Loggo_Poll when it fires. It is an eventfd on Linux and a pipe
+ * on other unixes, -1 where neither exists (poll on a timer instead). Shutdown closes it.
+ * Poll writes up to budget messages (0 for everything queued) and returns how many it wrote, the
+ * descriptor stays readable while the budget leaves messages behind.
+ * A producer that finds a threadless queue full writes it out itself instead of waiting.
+ */
+MINT_LOGGO_DEF int Mint_Loggo_EventFd();
+MINT_LOGGO_DEF uint32_t Mint_Loggo_Poll(uint32_t budget);
+
+
+/*
+ * Define MINT_LOGGO_LATENCY_STATS wherever the header is included to time every message through its
+ * logger, without it the stamps, histograms and these calls are not compiled at all.
+ * Each message is stamped when submitted, taken by a writer, laid out and written. Every logger keeps a
+ * log-linear histogram per stage (32 buckets per power of two, within about 3%), children count towards
+ * the logger that owns their queue. Reset clears them before the next message is recorded.
+ * ReportLatency logs a summary line at INFO to report_to every interval_ms (checked as messages are
+ * written, 0 stops it) and starts the histograms over after each one. report_to is borrowed like a
+ * logger name and must not write through the reporting logger's queue. A report is skipped while
+ * report_to doesnt exist and dropped when its queue is full, the reporting logger never waits on it.
+ * Returns false for an unknown logger or report_to
+ */
+#ifdef MINT_LOGGO_LATENCY_STATS
+MINT_LOGGO_DEF bool Mint_Loggo_GetLatency(const char* name, Mint_Loggo_LatencyStage stage, Mint_Loggo_LatencySummary* summary);
+MINT_LOGGO_DEF bool Mint_Loggo_ResetLatency(const char* name);
+MINT_LOGGO_DEF bool Mint_Loggo_ReportLatency(const char* name, const char* report_to, uint32_t interval_ms);
+#endif
+
+
+/*
+ * Loggers created before fork keep working in the child, nothing has to be called.
+ * The first logger of a process registers pthread_atfork handlers. Before fork every logger thread
+ * writes out what is queued and parks, then every queue lock is taken. Getting into a full queue and
+ * parking behind a slow sink share MINT_LOGGO_FORK_QUIESCE_MS, a logger that misses it is forked
+ * wherever its thread is. The child gets fresh locks, drops anything the parent still had
+ * queued (the parent writes it) and restarts its logger threads, or leaves them for the first message
+ * with format.fork_lazy. File sinks opened with per_process move to their own file in the child,
+ * every other sink is shared with the parent. Threadless loggers need Mint_Loggo_EventFd called again.
+ */
+
+
 /* 
  * Pass messages to the log queue, the logging thread will accept messages,
  * then use the handler methods (or defaults) to output logs
@@ -150,27 +519,129 @@ MINT_LOGGO_DEF void Mint_Loggo_DeleteLogger(const char* name);
 MINT_LOGGO_DEF void Mint_Loggo_Log(const char* name, Mint_Loggo_LogLevel level, const char* msg);
 MINT_LOGGO_DEF void Mint_Loggo_Log2(const char* name, Mint_Loggo_LogLevel level, char* msg, bool free_string);
 
+
+/*
+ * Hand a malloced string to the logger without copying it, the logger thread frees it.
+ * With a write_vec_handler and no sanitizing the text goes to the sink straight from msg,
+ * Log2 with free_string set does the same
+ */
+MINT_LOGGO_DEF void Mint_Loggo_LogMove(const char* name, Mint_Loggo_LogLevel level, char* msg);
+
+
+/*
+ * Borrow msg instead of copying it, only the pointer and len are queued and the logger thread writes
+ * the text from where it is. msg must outlive the logger, which string literals do.
+ * The LOG_STATIC_* helpers only take literals and pass their length from sizeof
+ */
+MINT_LOGGO_DEF void Mint_Loggo_LogStatic(const char* name, Mint_Loggo_LogLevel level, const char* msg, size_t len);
+
+
+/*
+ * Deferred formatting, the caller serializes its arguments straight into the message
+ * and the formatter turns them into text on the logger thread.
+ * The payload lives inside the message allocation so there is no extra copy.
+ */
+MINT_LOGGO_DEF Mint_Loggo_Deferred Mint_Loggo_BeginDeferred(const char* name, Mint_Loggo_LogLevel level, Mint_Loggo_FormatFn formatter, size_t payload_size);
+MINT_LOGGO_DEF void Mint_Loggo_CommitDeferred(Mint_Loggo_Deferred deferred);
+
+
+/*
+ * Trace spans and instant events, only the span pointer, a timestamp and the thread id are queued
+ * so span names must be string literals (or otherwise outlive the logger).
+ * Point them at a logger with MINT_LOGGO_OUTPUT_TRACE to get a trace file, other outputs print them as lines.
+ * Trace events are not filtered by level.
+ */
+MINT_LOGGO_DEF void Mint_Loggo_TraceBegin(const char* name, const char* span);
+MINT_LOGGO_DEF void Mint_Loggo_TraceEnd(const char* name, const char* span);
+MINT_LOGGO_DEF void Mint_Loggo_TraceInstant(const char* name, const char* event);
+
+// OS thread id of the caller, cached per thread
+MINT_LOGGO_DEF uint64_t Mint_Loggo_ThreadId();
+
+/*
+ * Per thread context fields (request ids and such) that go on every line the thread logs.
+ * They are rendered once when set, messages only take a reference to the rendered text.
+ * Text lines show them as key=value, sanitized like the message when the format asks for it.
+ * A NULL value removes the key, returns false when all MINT_LOGGO_CONTEXT_FIELDS are taken.
+ * Call Mint_Loggo_ContextClear before a thread that set fields exits or they leak.
+ */
+MINT_LOGGO_DEF bool Mint_Loggo_ContextSet(const char* key, const char* value);
+MINT_LOGGO_DEF void Mint_Loggo_ContextClear();
+
 // Loggo Handler methods
 
 // FILE* friends
 MINT_LOGGO_DEF int Mint_Loggo_StreamWrite(char* text, void* arg);
+MINT_LOGGO_DEF int Mint_Loggo_StreamWriteLen(const char* text, size_t len, void* arg);
+MINT_LOGGO_DEF int Mint_Loggo_StreamWriteVec(const Mint_Loggo_IoVec* parts, int count, void* arg);
 MINT_LOGGO_DEF int Mint_Loggo_StreamClose(void* arg);
 MINT_LOGGO_DEF int Mint_Loggo_StreamFlush(void* arg);
 
 // Raw Descriptor IO
 MINT_LOGGO_DEF int Mint_Loggo_DescriptorWrite(char* text, void* arg);
+MINT_LOGGO_DEF int Mint_Loggo_DescriptorWriteLen(const char* text, size_t len, void* arg);
+MINT_LOGGO_DEF int Mint_Loggo_DescriptorWriteVec(const Mint_Loggo_IoVec* parts, int count, void* arg);
 MINT_LOGGO_DEF int Mint_Loggo_DescriptorClose(void* arg);
 MINT_LOGGO_DEF int Mint_Loggo_DescriptorFlush(void* arg);
 
 // Do nothing
 MINT_LOGGO_DEF int Mint_Loggo_NullWrite(char* text, void* arg);
+MINT_LOGGO_DEF int Mint_Loggo_NullWriteLen(const char* text, size_t len, void* arg);
+MINT_LOGGO_DEF int Mint_Loggo_NullWriteVec(const Mint_Loggo_IoVec* parts, int count, void* arg);
 MINT_LOGGO_DEF int Mint_Loggo_NullClose(void* arg);
 MINT_LOGGO_DEF int Mint_Loggo_NullFlush(void* arg);
 
+// Unix domain socket sink
+// Records are batched into frames of frame_size bytes and sent without blocking the logger thread.
+// While the peer is gone frames are buffered (up to buffer_size) and the sink reconnects with backoff.
+// MINT_LOGGO_OVERFLOW_BLOCK waits for a slow but connected peer which pushes back onto the queue,
+// a disconnected peer never blocks and drops the newest records instead.
+// Returns NULL if the config is invalid, the first connect is allowed to fail
+MINT_LOGGO_DEF Mint_Loggo_SocketSink* Mint_Loggo_SocketOpen(const Mint_Loggo_SocketConfig* config);
+MINT_LOGGO_DEF int Mint_Loggo_SocketWrite(char* text, void* arg);
+MINT_LOGGO_DEF int Mint_Loggo_SocketWriteLen(const char* text, size_t len, void* arg);
+MINT_LOGGO_DEF int Mint_Loggo_SocketWriteVec(const Mint_Loggo_IoVec* parts, int count, void* arg);
+MINT_LOGGO_DEF int Mint_Loggo_SocketClose(void* arg);
+MINT_LOGGO_DEF int Mint_Loggo_SocketFlush(void* arg);
+MINT_LOGGO_DEF uint64_t Mint_Loggo_SocketDropped(Mint_Loggo_SocketSink* sink);
+
+// Log file with a sidecar index
+// Every index_records records or index_bytes bytes an entry with the chunk's offset, time range and
+// per level counts is appended to the index, tools/loggo_query uses it to only read matching chunks.
+// Returns NULL if either file cant be opened
+MINT_LOGGO_DEF Mint_Loggo_FileSink* Mint_Loggo_FileOpen(const Mint_Loggo_FileConfig* config);
+MINT_LOGGO_DEF int Mint_Loggo_FileWrite(char* text, void* arg);
+MINT_LOGGO_DEF int Mint_Loggo_FileWriteLen(const char* text, size_t len, void* arg);
+MINT_LOGGO_DEF int Mint_Loggo_FileWriteVec(const Mint_Loggo_IoVec* parts, int count, void* arg);
+MINT_LOGGO_DEF void Mint_Loggo_FileRecord(Mint_Loggo_LogLevel level, uint64_t nanos, void* arg);
+MINT_LOGGO_DEF int Mint_Loggo_FileClose(void* arg);
+MINT_LOGGO_DEF int Mint_Loggo_FileFlush(void* arg);
+
+// LZ block codec used by compressed file sinks, no dependencies and no state between blocks
+// table needs MINT_LOGGO_LZ_TABLE_SIZE entries, dst needs Mint_Loggo_LZBound(len) bytes
+// Decompress returns the decoded length or SIZE_MAX if the block is corrupt or does not fit
+#define MINT_LOGGO_LZ_TABLE_SIZE 4096U
+MINT_LOGGO_DEF size_t Mint_Loggo_LZBound(size_t len);
+MINT_LOGGO_DEF size_t Mint_Loggo_LZCompress(const void* src, size_t len, void* dst, uint32_t* table);
+MINT_LOGGO_DEF size_t Mint_Loggo_LZDecompress(const void* src, size_t len, void* dst, size_t capacity);
+
 #ifdef __cplusplus
 }
 #endif
 
+// Ends the span when it goes out of scope, see TRACE_SCOPE
+typedef struct {
+    const char* name;
+    const char* span;
+} Mint_Loggo_TraceScope;
+
+static inline void Mint_Loggo_TraceScopeEnd(Mint_Loggo_TraceScope* scope) {
+    Mint_Loggo_TraceEnd(scope->name, scope->span);
+}
+
+#define MINT_LOGGO_CONCAT_(a, b) a##b
+#define MINT_LOGGO_CONCAT(a, b) MINT_LOGGO_CONCAT_(a, b)
+
 // Convenience Macros for logging
 #ifdef MINT_LOGGO_USE_HELPERS
     #define LOG_DEBUG(name, msg) Mint_Loggo_Log((name), MINT_LOGGO_LEVEL_DEBUG, (msg))
@@ -185,6 +656,24 @@ MINT_LOGGO_DEF int Mint_Loggo_NullFlush(void* arg);
     #define LOG2_ERROR(name, msg, free_string) Mint_Loggo_Log2((name), MINT_LOGGO_LEVEL_ERROR, (msg), (free_string))
     #define LOG2_FATAL(name, msg, free_string) Mint_Loggo_Log2((name), MINT_LOGGO_LEVEL_FATAL, (msg), (free_string))
 
+    // "" msg does not compile for anything but a literal
+    #define LOG_STATIC_DEBUG(name, msg) Mint_Loggo_LogStatic((name), MINT_LOGGO_LEVEL_DEBUG, ("" msg), sizeof(msg) - 1U)
+    #define LOG_STATIC_INFO(name, msg) Mint_Loggo_LogStatic((name), MINT_LOGGO_LEVEL_INFO, ("" msg), sizeof(msg) - 1U)
+    #define LOG_STATIC_WARN(name, msg) Mint_Loggo_LogStatic((name), MINT_LOGGO_LEVEL_WARN, ("" msg), sizeof(msg) - 1U)
+    #define LOG_STATIC_ERROR(name, msg) Mint_Loggo_LogStatic((name), MINT_LOGGO_LEVEL_ERROR, ("" msg), sizeof(msg) - 1U)
+    #define LOG_STATIC_FATAL(name, msg) Mint_Loggo_LogStatic((name), MINT_LOGGO_LEVEL_FATAL, ("" msg), sizeof(msg) - 1U)
+
+    #define TRACE_BEGIN(name, span) Mint_Loggo_TraceBegin((name), (span))
+    #define TRACE_END(name, span) Mint_Loggo_TraceEnd((name), (span))
+    #define TRACE_INSTANT(name, event) Mint_Loggo_TraceInstant((name), (event))
+
+    // Span covering the rest of the enclosing block (GCC/Clang cleanup attribute)
+    #if defined(__GNUC__) || defined(__clang__)
+        #define TRACE_SCOPE(name, span) \
+            __attribute__((cleanup(Mint_Loggo_TraceScopeEnd))) Mint_Loggo_TraceScope MINT_LOGGO_CONCAT(mint_loggo_scope_, __LINE__) = \
+                (Mint_Loggo_TraceBegin((name), (span)), (Mint_Loggo_TraceScope){(name), (span)})
+    #endif
+
     #define STDOUT_STREAM_HANDLER (Mint_Loggo_LogHandler) { \
                                     .handle=stdout, \
                                     .write_handler=Mint_Loggo_StreamWrite, \
@@ -237,11 +726,63 @@ MINT_LOGGO_DEF int Mint_Loggo_NullFlush(void* arg);
     #define MINT_LOGGO_WHITE    "\033[37m"
     #define MINT_LOGGO_RESET    "\033[0m"
 
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/uio.h>
+    #include <sys/un.h>
+
+    #define MINT_LOGGO_HAS_SOCKETS
+
+    #ifdef __linux__
+        #include <sys/eventfd.h>
+        #include <sys/prctl.h>
+        #include <sys/syscall.h>
+    #endif
+
+    #define MINT_LOGGO_HAS_EVENT_FD
+    #define MINT_LOGGO_HAS_FORK
+
+    #define MINT_LOGGO_GET_PID() ((uint64_t)getpid())
+
+    // Apple has SO_NOSIGPIPE instead
+    #ifndef MSG_NOSIGNAL
+        #define MSG_NOSIGNAL 0
+    #endif
+
     MINT_LOGGO_DEF int Mint_Loggo_DescriptorWrite(char* text, void* arg) {
         return write(*(int*)arg, text, strlen(text));
     }
 
 
+    MINT_LOGGO_DEF int Mint_Loggo_DescriptorWriteLen(const char* text, size_t len, void* arg) {
+        return write(*(int*)arg, text, len);
+    }
+
+
+    // Lines are only a few pieces, longer lists go out in chunks
+    MINT_LOGGO_DEF int Mint_Loggo_DescriptorWriteVec(const Mint_Loggo_IoVec* parts, int count, void* arg) {
+        struct iovec vectors[8];
+        int written = 0;
+        for (int done = 0; done < count;) {
+            int chunk = 0;
+            for (; chunk < 8 && done + chunk < count; chunk++) {
+                vectors[chunk].iov_base = (void*)parts[done + chunk].data;
+                vectors[chunk].iov_len = parts[done + chunk].len;
+            }
+
+            ssize_t result = writev(*(int*)arg, vectors, chunk);
+            if (result < 0) {
+                return -1;
+            }
+            written += (int)result;
+            done += chunk;
+        }
+        return written;
+    }
+
+
     MINT_LOGGO_DEF int Mint_Loggo_DescriptorClose(void* arg) {
         return close(*(int*)arg);
     }
@@ -260,6 +801,26 @@ MINT_LOGGO_DEF int Mint_Loggo_NullFlush(void* arg);
         return _write(*(int*)arg, text, strlen(text));
     }
 
+
+    MINT_LOGGO_DEF int Mint_Loggo_DescriptorWriteLen(const char* text, size_t len, void* arg) {
+        return _write(*(int*)arg, text, (unsigned int)len);
+    }
+
+
+    MINT_LOGGO_DEF int Mint_Loggo_DescriptorWriteVec(const Mint_Loggo_IoVec* parts, int count, void* arg) {
+        int written = 0;
+        for (int idx = 0; idx < count; idx++) {
+            int result = _write(*(int*)arg, parts[idx].data, (unsigned int)parts[idx].len);
+            if (result < 0) {
+                return -1;
+            }
+            written += result;
+        }
+        return written;
+    }
+
+    #define MINT_LOGGO_GET_PID() ((uint64_t)GetCurrentProcessId())
+
     
     MINT_LOGGO_DEF int Mint_Loggo_DescriptorClose(void* arg) {
         return _close(*(int*)arg);
@@ -279,6 +840,20 @@ MINT_LOGGO_DEF int Mint_Loggo_StreamWrite(char* text, void* arg) {
 }
 
 
+MINT_LOGGO_DEF int Mint_Loggo_StreamWriteLen(const char* text, size_t len, void* arg) {
+    return (int)fwrite(text, 1U, len, (FILE*)arg);
+}
+
+
+MINT_LOGGO_DEF int Mint_Loggo_StreamWriteVec(const Mint_Loggo_IoVec* parts, int count, void* arg) {
+    int written = 0;
+    for (int idx = 0; idx < count; idx++) {
+        written += (int)fwrite(parts[idx].data, 1U, parts[idx].len, (FILE*)arg);
+    }
+    return written;
+}
+
+
 MINT_LOGGO_DEF int Mint_Loggo_StreamClose(void* arg) {
    return fclose((FILE*)arg);
 }
@@ -296,6 +871,22 @@ MINT_LOGGO_DEF int Mint_Loggo_NullWrite(char* text, void* arg) {
 }
 
 
+MINT_LOGGO_DEF int Mint_Loggo_NullWriteLen(const char* text, size_t len, void* arg) {
+    MINT_LOGGO_UNUSED(arg);
+    MINT_LOGGO_UNUSED(text);
+    MINT_LOGGO_UNUSED(len);
+    return 0;
+}
+
+
+MINT_LOGGO_DEF int Mint_Loggo_NullWriteVec(const Mint_Loggo_IoVec* parts, int count, void* arg) {
+    MINT_LOGGO_UNUSED(arg);
+    MINT_LOGGO_UNUSED(parts);
+    MINT_LOGGO_UNUSED(count);
+    return 0;
+}
+
+
 MINT_LOGGO_DEF int Mint_Loggo_NullClose(void* arg) {
     MINT_LOGGO_UNUSED(arg);
     return 0;
@@ -309,8 +900,42 @@ MINT_LOGGO_DEF int Mint_Loggo_NullFlush(void* arg) {
 
 
 
-static void* Mint_Loggo_ErrorCheckedMalloc(size_t size) {
-    void* ptr = malloc(size);
+#if defined(_MSC_VER)
+    #define MINT_LOGGO_THREAD_LOCAL __declspec(thread)
+#else
+    #define MINT_LOGGO_THREAD_LOCAL __thread
+#endif
+
+
+static void* Mint_Loggo_DefaultAlloc(size_t size, void* ctx) {
+    MINT_LOGGO_UNUSED(ctx);
+    return malloc(size);
+}
+
+
+static void* Mint_Loggo_DefaultRealloc(void* ptr, size_t size, void* ctx) {
+    MINT_LOGGO_UNUSED(ctx);
+    return realloc(ptr, size);
+}
+
+
+static void Mint_Loggo_DefaultFree(void* ptr, void* ctx) {
+    MINT_LOGGO_UNUSED(ctx);
+    free(ptr);
+}
+
+
+static Mint_Loggo_Allocator MINT_LOGGO_ALLOCATOR = {Mint_Loggo_DefaultAlloc, Mint_Loggo_DefaultRealloc, Mint_Loggo_DefaultFree, NULL};
+
+
+MINT_LOGGO_DEF void Mint_Loggo_SetAllocator(const Mint_Loggo_Allocator* allocator) {
+    Mint_Loggo_Allocator defaults = {Mint_Loggo_DefaultAlloc, Mint_Loggo_DefaultRealloc, Mint_Loggo_DefaultFree, NULL};
+    MINT_LOGGO_ALLOCATOR = allocator ? *allocator : defaults;
+}
+
+
+static void* Mint_Loggo_AllocatorMalloc(const Mint_Loggo_Allocator* allocator, size_t size) {
+    void* ptr = allocator->alloc(size, allocator->ctx);
     if (!ptr) {
         fprintf(stderr, "[ERROR] Exiting because malloc failed...");
         exit(EXIT_FAILURE);
@@ -319,8 +944,13 @@ static void* Mint_Loggo_ErrorCheckedMalloc(size_t size) {
 }
 
 
+static void* Mint_Loggo_ErrorCheckedMalloc(size_t size) {
+    return Mint_Loggo_AllocatorMalloc(&MINT_LOGGO_ALLOCATOR, size);
+}
+
+
 static void* Mint_Loggo_ErrorCheckedRealloc(void* original, size_t size) {
-    void* ptr = realloc(original, size);
+    void* ptr = MINT_LOGGO_ALLOCATOR.realloc(original, size, MINT_LOGGO_ALLOCATOR.ctx);
     if (!ptr) {
         fprintf(stderr, "[ERROR] Exiting because realloc failed...");
         exit(EXIT_FAILURE);
@@ -329,6 +959,13 @@ static void* Mint_Loggo_ErrorCheckedRealloc(void* original, size_t size) {
 }
 
 
+static void Mint_Loggo_AllocatorFree(void* ptr) {
+    if (ptr) {
+        MINT_LOGGO_ALLOCATOR.free(ptr, MINT_LOGGO_ALLOCATOR.ctx);
+    }
+}
+
+
 ////////////////////////////////////
 // Defaults
 ////////////////////////////////////
@@ -336,27 +973,199 @@ static void* Mint_Loggo_ErrorCheckedRealloc(void* original, size_t size) {
 #define MINT_LOGGO_DEFAULT_LINE_SEP "\n"
 #define MINT_LOGGO_DEFAULT_LINE_BEG ""
 #define MINT_LOGGO_DEFAULT_QUEUE_SIZE 1024U 
+#define MINT_LOGGO_DEFAULT_URGENT_QUEUE_SIZE 256U
 #define MINT_LOGGO_DEFAULT_TIME_FORMAT "%Y-%m-%d %H:%M:%S"
 #define MINT_LOGGO_DEFAULT_HT_INITIAL_CAPACITY 128
 #define MINT_LOGGO_DEFAULT_HT_INITIAL_LOAD_FACTOR 0.7f
-
-// Can be overriden by user
-#define MINT_LOGGO_MALLOC Mint_Loggo_ErrorCheckedMalloc
-#define MINT_LOGGO_REALLOC Mint_Loggo_ErrorCheckedRealloc
-#define MINT_LOGGO_FREE free
+#define MINT_LOGGO_HT_RETIRED_MAX 64
+#define MINT_LOGGO_DEFAULT_SCRATCH_SIZE 512U
+#define MINT_LOGGO_TSC_CALIBRATION_NS 1000000U
+#define MINT_LOGGO_TSC_RECALIBRATION_NS 1000000000U
+#define MINT_LOGGO_DEFAULT_SPIN_COUNT 4096U
+#define MINT_LOGGO_DEFAULT_YIELD_COUNT 64U
+#define MINT_LOGGO_DEFAULT_SOCKET_FRAME_SIZE (64U * 1024U)
+#define MINT_LOGGO_DEFAULT_SOCKET_BUFFER_SIZE (1024U * 1024U)
+#define MINT_LOGGO_DEFAULT_SOCKET_RECONNECT_MS 100U
+#define MINT_LOGGO_SOCKET_MAX_RECONNECT_MS 5000U
+#define MINT_LOGGO_DEFAULT_INDEX_RECORDS 4096U
+#define MINT_LOGGO_DEFAULT_INDEX_BYTES (1024U * 1024U)
+#define MINT_LOGGO_DEFAULT_BLOCK_SIZE (64U * 1024U)
+#define MINT_LOGGO_CONTEXT_FIELDS 8U
+#define MINT_LOGGO_LZ_MIN_MATCH 4U
+#define MINT_LOGGO_LZ_MAX_OFFSET 65535U
+
+#define MINT_LOGGO_FORK_QUIESCE_MS 1000U
+
+// Values below 64ns get a bucket each, above that 32 buckets per power of two (each within about 3%)
+// up to 2^42ns, about 73 minutes
+#define MINT_LOGGO_LATENCY_SUB_BUCKETS 32U
+#define MINT_LOGGO_LATENCY_MAX_SHIFT 36U
+#define MINT_LOGGO_LATENCY_BUCKETS (2U * MINT_LOGGO_LATENCY_SUB_BUCKETS + MINT_LOGGO_LATENCY_MAX_SHIFT * MINT_LOGGO_LATENCY_SUB_BUCKETS)
+
+#define MINT_LOGGO_DEFAULT_POOL_SLOT_SIZE 256U
+#define MINT_LOGGO_POOL_RETURN_BATCH 64U
+
+// Can be overriden by user, define all three before the implementation to bypass Mint_Loggo_SetAllocator
+#ifndef MINT_LOGGO_MALLOC
+    #define MINT_LOGGO_MALLOC Mint_Loggo_ErrorCheckedMalloc
+    #define MINT_LOGGO_REALLOC Mint_Loggo_ErrorCheckedRealloc
+    #define MINT_LOGGO_FREE Mint_Loggo_AllocatorFree
+#endif
 
 
 ////////////////////////////////////
 // Types
 ////////////////////////////////////
 
+// What a message carries, trace kinds borrow the span name in msg
+typedef enum {
+    MINT_LOGGO_MESSAGE_LOG,
+    MINT_LOGGO_MESSAGE_TRACE_BEGIN,
+    MINT_LOGGO_MESSAGE_TRACE_END,
+    MINT_LOGGO_MESSAGE_TRACE_INSTANT,
+    MINT_LOGGO_MESSAGE_RECONFIGURE,     // payload is a Mint_Loggo_Reconfigure, never written
+    MINT_LOGGO_MESSAGE_FORK             // Parks the logger thread until fork is done, never written
+} Mint_Loggo_MessageKind;
+
+
+// Changes only the logger thread can make, the caller waits on MINT_LOGGO_WAIT_SIGNAL until done is set
+typedef struct {
+    Mint_Loggo_LogHandler* handler;     // NULL keeps the current one
+    int32_t colors;                     // -1 keeps the current setting
+    bool done;
+    bool dropped;                       // Thrown away with the queue, nothing was changed
+} Mint_Loggo_Reconfigure;
+
+
+// Rendered context fields shared by every message logged while they were set
+// text is "key=value " pairs, escaped and stripped are the same pairs for text formats that sanitize,
+// json is ,"key":"value" pairs, all of them live behind the struct
+typedef struct {
+    uint32_t refs;
+    uint32_t text_len;
+    uint32_t escaped_len;
+    uint32_t stripped_len;
+    uint32_t json_len;
+    char* text;
+    char* escaped;
+    char* stripped;
+    char* json;
+} Mint_Loggo_Context;
+
+
+// What a thread has set, the current rendering is swapped out on every change
+typedef struct {
+    char* keys[MINT_LOGGO_CONTEXT_FIELDS];
+    char* values[MINT_LOGGO_CONTEXT_FIELDS];
+    uint32_t count;
+    Mint_Loggo_Context* current;
+} Mint_Loggo_ThreadContext;
+
+
 // Messages are always created and must be freed
 typedef struct {
     Mint_Loggo_LogLevel level;
+    Mint_Loggo_MessageKind kind;
     bool done;
+    bool adopted;       // msg is the callers malloced buffer, its length is found on the logger thread
+    bool borrowed;      // msg outlives the logger (a literal), written from where it is and never freed
+    uint64_t thread_id;
     char* msg;
+    size_t msg_len;
+    uint64_t timestamp;
+    Mint_Loggo_FormatFn formatter;
+    void* payload;
+    Mint_Loggo_Context* context;
+    struct Mint_Loggo_Logger* source;   // The child it was logged through, NULL for the owner itself
+    #ifdef MINT_LOGGO_LATENCY_STATS
+        uint64_t stamps[3];             // Monotonic ns when submitted, taken and laid out
+    #endif
 } Mint_Loggo_LogMessage;
 
+// Deferred payloads start after the message, keep them aligned for anything
+#define MINT_LOGGO_MESSAGE_HEADER_SIZE ((sizeof(Mint_Loggo_LogMessage) + 15U) & ~(size_t)15U)
+
+
+
+#ifdef MINT_LOGGO_LATENCY_STATS
+typedef enum {
+    MINT_LOGGO_STAMP_SUBMITTED,
+    MINT_LOGGO_STAMP_TAKEN,
+    MINT_LOGGO_STAMP_FORMATTED
+} Mint_Loggo_Stamp;
+
+// Only the logger's writer records, readers load the counts as they are
+// Reports are due from next_report_ns, reset is a request the writer carries out
+typedef struct {
+    uint64_t counts[MINT_LOGGO_LATENCY_STAGES][MINT_LOGGO_LATENCY_BUCKETS];
+    uint64_t sums[MINT_LOGGO_LATENCY_STAGES];
+    uint64_t mins[MINT_LOGGO_LATENCY_STAGES];
+    uint64_t maxes[MINT_LOGGO_LATENCY_STAGES];
+    uint64_t messages;
+    uint32_t reset;
+    const char* report_to;
+    uint32_t report_interval_ms;
+    uint64_t next_report_ns;
+} Mint_Loggo_LatencyStats;
+
+    #define MINT_LOGGO_STAMP(message, stamp) ((message)->stamps[(stamp)] = Mint_Loggo_MonotonicNs())
+    #define MINT_LOGGO_RECORD_LATENCY(logger, message) Mint_Loggo_RecordLatency((logger), (message))
+#else
+    #define MINT_LOGGO_STAMP(message, stamp) ((void)0)
+    #define MINT_LOGGO_RECORD_LATENCY(logger, message) ((void)0)
+#endif
+
+
+// Maps cycle counter values to nanoseconds since the epoch
+typedef struct {
+    uint64_t anchor_cycles;
+    uint64_t anchor_ns;
+    double ns_per_cycle;
+    uint64_t next_calibration_cycles;
+    bool untrusted;                    // Measured once and found unusable
+} Mint_Loggo_CycleClock;
+
+
+// One slot per level plus one for anything unknown
+#define MINT_LOGGO_LEVEL_SLOTS (MINT_LOGGO_LEVEL_FATAL + 2)
+
+
+// Precomputed text around the time and the message so a line is a few memcpys
+// prefix is color + linebeg + " [", tag is "] LEVEL ", suffix is linesep + reset
+typedef struct {
+    char* prefix;
+    char* tag;
+    char* suffix;
+    size_t prefix_len;
+    size_t tag_len;
+    size_t suffix_len;
+} Mint_Loggo_LinePieces;
+
+
+// Fixed size message slots carved out of one block
+// Producers pop under the lock, the logger thread gathers freed slots and hands them back a batch at a time
+typedef struct Mint_Loggo_PoolSlot {
+    struct Mint_Loggo_PoolSlot* next;
+} Mint_Loggo_PoolSlot;
+
+typedef struct {
+    char* block;
+    size_t slot_size;
+    uint32_t slots;
+    Mint_Loggo_PoolSlot* free_slots;
+    Mint_Loggo_PoolSlot* returned;
+    Mint_Loggo_PoolSlot* returned_tail;
+    uint32_t returned_count;
+    MINT_LOGGO_MUTEX_TYPE pool_lock;
+} Mint_Loggo_MessagePool;
+
+
+// Urgent messages skip ahead of the bulk lane, order is kept within a lane
+typedef enum {
+    MINT_LOGGO_LANE_BULK,
+    MINT_LOGGO_LANE_URGENT,
+    MINT_LOGGO_LANES
+} Mint_Loggo_LaneId;
 
 
 // Circular dynamic array implementation
@@ -364,8 +1173,16 @@ typedef struct {
     uint32_t head;
     uint32_t tail;
     uint32_t capacity;
-    uint32_t size;
     Mint_Loggo_LogMessage** messages;
+} Mint_Loggo_LogLane;
+
+
+// The lanes share one lock, size counts both
+typedef struct {
+    Mint_Loggo_LogLane lanes[MINT_LOGGO_LANES];
+    uint32_t size;
+    bool consumer_parked;
+    bool closed;
     MINT_LOGGO_MUTEX_TYPE queue_lock;
     MINT_LOGGO_COND_TYPE queue_not_full;
     MINT_LOGGO_COND_TYPE queue_not_empty;
@@ -373,7 +1190,8 @@ typedef struct {
 
 
 // Contains everything a logger will need
-typedef struct {
+// Children borrow format, queue and thread from owner and only keep their name, level and line pieces
+typedef struct Mint_Loggo_Logger {
     Mint_Loggo_LogFormat* format;
     Mint_Loggo_LogHandler* handler;
     Mint_Loggo_LogQueue* queue;
@@ -381,17 +1199,115 @@ typedef struct {
     MINT_LOGGO_THREAD_TYPE thread_id;
     const char* name;
     bool done;
-
+    char* scratch;
+    size_t scratch_capacity;
+    char* render;
+    size_t render_capacity;
+    Mint_Loggo_LinePieces pieces[MINT_LOGGO_LEVEL_SLOTS];
+    time_t time_cache_stamp;
+    bool time_cache_valid;
+    size_t time_cache_len;
+    char time_cache[128U * 6U];         // Room for a 128 byte time escaped for JSON
+    Mint_Loggo_CycleClock clock;
+    uint64_t pid;
+    uint64_t trace_events;
+    uint32_t state;
+    Mint_Loggo_Allocator allocator;     // Copied so a later SetAllocator doesnt change where messages go back to
+    Mint_Loggo_MessagePool* pool;
+    uint32_t abandon;
+    uint32_t exited;
+    uint64_t abandoned;                 // Messages an abandoned thread threw away on its way out
+    uint32_t holds;                     // Callers using the logger outside the registry lock, freeing waits for them
+    MINT_LOGGO_MUTEX_TYPE sink_lock;    // Only used by PRIORITY_SYNC, callers write urgent messages themselves
+    Mint_Loggo_LogLevel level;          // Effective level, the only thing producers check
+    int32_t own_level;                  // -1 follows the nearest dotted ancestor
+    bool level_resolved;
+    struct Mint_Loggo_Logger* owner;    // Set for children
+    struct Mint_Loggo_Logger* orphans;  // Children deleted while it was stopping with their messages still queued, freed with it
+    struct Mint_Loggo_Logger* next_orphan;
+    bool unlinked;                      // Owner out of the table, its thread is stopped without the registry lock
+    uint32_t pieces_generation;         // Bumped when the owner rebuilds, children rebuild to match
+    uint32_t fork_parked;               // Logger thread is holding nothing while a fork is under way
+    bool fork_queued;                   // Its FORK message got in before the deadline, the fork waits for it to park
+    #ifdef MINT_LOGGO_LATENCY_STATS
+        Mint_Loggo_LatencyStats* latency;   // Owners only
+    #endif
 } Mint_Loggo_Logger;
 
+// Lazy loggers go idle -> starting -> running once, everyone else is running from the start
+typedef enum {
+    MINT_LOGGO_LOGGER_IDLE,
+    MINT_LOGGO_LOGGER_STARTING,
+    MINT_LOGGO_LOGGER_RUNNING
+} Mint_Loggo_LoggerState;
+
+
+// Memory a reader may still be looking at, freed once every lookup that could have seen it is done
+typedef struct Mint_Loggo_Retired {
+    struct Mint_Loggo_Retired* next;
+    void* memory;
+} Mint_Loggo_Retired;
+
+
+// Writers hold the registry lock, readers dont lock and look again when a rehash ran under them
 typedef struct {
     Mint_Loggo_Logger** loggers;
     int32_t size;
     int32_t capacity;
     double load_factor;
+    int32_t deleted;            // Tombstones, they lengthen probes so they count towards the load
+    uint32_t generation;        // Odd while a rehash is publishing
+    Mint_Loggo_Retired* retired;
+    int32_t retired_count;      // Reclaimed at MINT_LOGGO_HT_RETIRED_MAX
 } Mint_Loggo_HashTable;
 
 
+#ifdef MINT_LOGGO_HAS_SOCKETS
+// A batch of whole records sent with one send call
+typedef struct {
+    char* data;
+    uint32_t len;
+    uint32_t capacity;
+    uint32_t sent;
+    uint32_t records;
+} Mint_Loggo_SocketFrame;
+
+
+// Frames form a ring, the newest frame is open for appends
+struct Mint_Loggo_SocketSink {
+    Mint_Loggo_SocketConfig config;
+    char* path;
+    int fd;
+    Mint_Loggo_SocketFrame* frames;
+    uint32_t frame_count;
+    uint32_t first;
+    uint32_t used;
+    uint32_t backoff_ms;
+    uint64_t next_connect_ms;
+    uint64_t dropped;
+};
+#endif
+
+
+// Bytes are counted as they are written so offsets never need a seek
+// Compressed sinks gather records in block and pack them into packed, offsets count frame bytes
+struct Mint_Loggo_FileSink {
+    Mint_Loggo_FileConfig config;
+    FILE* file;
+    FILE* index;
+    uint64_t offset;
+    Mint_Loggo_IndexEntry chunk;
+    char* block;
+    size_t block_len;
+    size_t block_capacity;
+    char* packed;
+    size_t packed_capacity;
+    uint32_t* table;
+    char* path;                 // Kept for per process sinks only
+    char* index_path;
+    uint64_t pid;               // Process the files belong to
+};
+
 ////////////////////////////////////
 // Constants
 ////////////////////////////////////
@@ -404,7 +1320,20 @@ static const int32_t MINT_LOGGO_PRIME_2 = 197U;
 ////////////////////////////////////
 static Mint_Loggo_LogMessage MINT_LOGGO_LOGGER_TERMINATE = {.done = true};
 static Mint_Loggo_Logger MINT_LOGGO_LOGGER_DELETED = {0};
+static int MINT_LOGGO_EVENT_FDS[2] = {-1, -1};     // Read and write end, the same eventfd on Linux
+static uint32_t MINT_LOGGO_EVENT_ARMED = 0U;
+static int32_t MINT_LOGGO_POLL_CURSOR = 0;
+static uint32_t MINT_LOGGO_FORK_HOLD = 0U;
+static MINT_LOGGO_MUTEX_TYPE MINT_LOGGO_REGISTRY_LOCK = MINT_LOGGO_MUTEX_INITIALIZER;
+static MINT_LOGGO_MUTEX_TYPE MINT_LOGGO_WAIT_LOCK = MINT_LOGGO_MUTEX_INITIALIZER;
+static MINT_LOGGO_COND_TYPE MINT_LOGGO_WAIT_SIGNAL = MINT_LOGGO_COND_INITIALIZER;     // Broadcast when a logger thread exits, a reconfigure is done or a hold is let go
+static bool MINT_LOGGO_FORK_WATCHED = false;
+static MINT_LOGGO_THREAD_LOCAL uint64_t MINT_LOGGO_THREAD_ID = 0U;
+static Mint_Loggo_CycleClock MINT_LOGGO_CYCLE_CLOCK = {0};
 static Mint_Loggo_HashTable MINT_LOGGO_LOGGER_HASH_TABLE = {0};
+static uint32_t MINT_LOGGO_LOOKUP_EPOCH = 0U;
+static uint32_t MINT_LOGGO_LOOKUP_READERS[2] = {0U, 0U};
+static MINT_LOGGO_THREAD_LOCAL Mint_Loggo_ThreadContext MINT_LOGGO_THREAD_CONTEXT = {0};
 
 
 ////////////////////////////////////
@@ -413,34 +1342,145 @@ static Mint_Loggo_HashTable MINT_LOGGO_LOGGER_HASH_TABLE = {0};
 
 
 // Queue
-static Mint_Loggo_LogQueue* Mint_Loggo_CreateQueue(uint32_t capacity);
+static Mint_Loggo_LogQueue* Mint_Loggo_CreateQueue(uint32_t capacity, uint32_t urgent_capacity);
 static void Mint_Loggo_DestroyQueue(Mint_Loggo_LogQueue* queue);
-static bool Mint_Loggo_IsQueueFull(Mint_Loggo_LogQueue* queue);
+static bool Mint_Loggo_IsLaneFull(Mint_Loggo_LogLane* lane);
+static bool Mint_Loggo_IsLaneEmpty(Mint_Loggo_LogLane* lane);
 static bool Mint_Loggo_IsQueueEmpty(Mint_Loggo_LogQueue* queue);
-static void Mint_Loggo_Enqueue(Mint_Loggo_LogQueue* queue, Mint_Loggo_LogMessage* message);
+static void Mint_Loggo_Enqueue(Mint_Loggo_LogQueue* queue, Mint_Loggo_LogMessage* message, Mint_Loggo_LaneId lane_id);
+static bool Mint_Loggo_TryEnqueue(Mint_Loggo_LogQueue* queue, Mint_Loggo_LogMessage* message, Mint_Loggo_LaneId lane_id);
+static bool Mint_Loggo_EnqueueIfOpen(Mint_Loggo_LogQueue* queue, Mint_Loggo_LogMessage* message, Mint_Loggo_LaneId lane_id);
+static void Mint_Loggo_PushMessage(Mint_Loggo_LogQueue* queue, Mint_Loggo_LogLane* lane, Mint_Loggo_LogMessage* message);
+static Mint_Loggo_LogMessage* Mint_Loggo_PopMessage(Mint_Loggo_LogQueue* queue);
 static Mint_Loggo_LogMessage* Mint_Loggo_Dequeue(Mint_Loggo_LogQueue* queue);
+static Mint_Loggo_LogMessage* Mint_Loggo_TryDequeue(Mint_Loggo_LogQueue* queue);
+static void Mint_Loggo_CloseQueue(Mint_Loggo_LogQueue* queue);
+static void Mint_Loggo_WaitForMessages(Mint_Loggo_LogQueue* queue, Mint_Loggo_LogFormat* format);
 
 // Logging
 static void* Mint_Loggo_RunLogger(void* arg);
+static void Mint_Loggo_StartLogger(Mint_Loggo_Logger* logger);
+static void* Mint_Loggo_AllocMessage(Mint_Loggo_Logger* logger, size_t size);
+static void Mint_Loggo_FreeMessage(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message);
+static void Mint_Loggo_ReleaseMessage(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message);
+static Mint_Loggo_MessagePool* Mint_Loggo_CreatePool(const Mint_Loggo_Allocator* allocator, uint32_t slots, size_t slot_size);
+static void Mint_Loggo_DestroyPool(Mint_Loggo_MessagePool* pool, const Mint_Loggo_Allocator* allocator);
+static void Mint_Loggo_PoolReturn(Mint_Loggo_MessagePool* pool);
+static void Mint_Loggo_WakeLogger(Mint_Loggo_Logger* logger);
+static Mint_Loggo_Logger* Mint_Loggo_OwnerOf(Mint_Loggo_Logger* logger);
+static Mint_Loggo_Logger* Mint_Loggo_FindAncestor(const char* name);
+static void Mint_Loggo_ResolveLevels();
+static Mint_Loggo_LogLevel Mint_Loggo_ResolveLevel(Mint_Loggo_Logger* logger);
+static void Mint_Loggo_DropChildren(Mint_Loggo_Logger* owner, bool release);
+static void Mint_Loggo_ConfigureThread(Mint_Loggo_LogFormat* format);
 static char* Mint_Loggo_StringFromLevel(Mint_Loggo_LogLevel level);
 static char* Mint_Loggo_ColorFromLevel(Mint_Loggo_LogLevel level);
 static Mint_Loggo_LogMessage* Mint_Loggo_CreateLogMessage(Mint_Loggo_Logger* logger, Mint_Loggo_LogLevel level, const char* msg);
+static void Mint_Loggo_Trace(const char* name, Mint_Loggo_MessageKind kind, const char* span);
+static size_t Mint_Loggo_AssembleTrace(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message);
+static void Mint_Loggo_WriteOut(Mint_Loggo_Logger* logger, const char* text, size_t len);
+static void Mint_Loggo_FlushSink(Mint_Loggo_Logger* logger);
 static Mint_Loggo_LogFormat* Mint_Loggo_CreateLogFormat(Mint_Loggo_LogFormat* user_format);
 static Mint_Loggo_LogHandler* Mint_Loggo_CreateLogHandler(Mint_Loggo_LogHandler* user_handler);
 static void Mint_Loggo_DestroyLogHandler(Mint_Loggo_LogHandler* handler);
 static void Mint_Loggo_DestroyLogFormat(Mint_Loggo_LogFormat* format);
+static Mint_Loggo_Logger* Mint_Loggo_UnlinkLogger(Mint_Loggo_Logger* logger);
+static Mint_Loggo_Logger* Mint_Loggo_HoldOwner(const char* name);
+static void Mint_Loggo_LetGo(Mint_Loggo_Logger* logger);
+static void Mint_Loggo_WaitForHolds(Mint_Loggo_Logger* logger);
 static void Mint_Loggo_CleanUpLogger(Mint_Loggo_Logger* logger);
-static void Mint_Loggo_HandleLogMessage(Mint_Loggo_LogMessage* message, Mint_Loggo_LogFormat* format, Mint_Loggo_LogHandler* handler);
+static Mint_Loggo_Logger* Mint_Loggo_MakeLogger(const char* name, Mint_Loggo_LogFormat* user_format, Mint_Loggo_LogHandler* user_handler);
+static void Mint_Loggo_FreeLogger(Mint_Loggo_Logger* logger);
+static uint64_t Mint_Loggo_DropQueued(Mint_Loggo_Logger* logger);
+static void Mint_Loggo_HandleLogMessage(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message);
+static void Mint_Loggo_EmitMessage(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message);
+static void Mint_Loggo_Submit(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message);
+static void Mint_Loggo_WriteUrgent(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message);
+static bool Mint_Loggo_QueueReconfigure(Mint_Loggo_Logger* logger, Mint_Loggo_LogHandler* handler, int32_t colors);
+static void Mint_Loggo_ApplyReconfigure(Mint_Loggo_Logger* logger, Mint_Loggo_Reconfigure* reconfigure);
+static void Mint_Loggo_MarkDone(Mint_Loggo_Reconfigure* reconfigure, bool dropped);
+static bool Mint_Loggo_LocksSink(Mint_Loggo_Logger* logger);
+static uint32_t Mint_Loggo_DrainLogger(Mint_Loggo_Logger* logger, uint32_t budget);
+static void Mint_Loggo_FinishOutput(Mint_Loggo_Logger* logger);
+static void Mint_Loggo_MarkExited(Mint_Loggo_Logger* logger);
+static void Mint_Loggo_WaitForExits(Mint_Loggo_Logger** loggers, int32_t count, uint64_t deadline);
+static void Mint_Loggo_SignalPending();
+static void Mint_Loggo_ClearPending();
+static void Mint_Loggo_CloseEventFd();
+static void Mint_Loggo_StopLogger(Mint_Loggo_Logger* logger);
+static void Mint_Loggo_ParkForFork(Mint_Loggo_Logger* logger);
+static void Mint_Loggo_WatchForks();
+static void Mint_Loggo_ForkPrepare();
+static void Mint_Loggo_ForkParent();
+static void Mint_Loggo_ForkChild();
+static size_t Mint_Loggo_AssembleLine(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message);
+static size_t Mint_Loggo_AssembleHead(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message, size_t extra);
+static Mint_Loggo_LinePieces* Mint_Loggo_PiecesFor(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message);
+static void Mint_Loggo_BuildLinePieces(Mint_Loggo_Logger* logger);
+static void Mint_Loggo_DestroyLinePieces(Mint_Loggo_Logger* logger);
+static size_t Mint_Loggo_MakePiece(char** piece, const char* first, const char* second, const char* third);
+static void Mint_Loggo_ReserveBuffer(char** buffer, size_t* capacity, size_t size);
+static size_t Mint_Loggo_ScanClean(const char* text, size_t len);
+static size_t Mint_Loggo_SanitizeCopy(char* out, const char* text, size_t len, Mint_Loggo_Sanitize mode, bool json);
+static size_t Mint_Loggo_FormatTime(char* buffer, size_t size, const char* time_format, time_t timestamp);
+static size_t Mint_Loggo_FormatFraction(char* buffer, uint64_t nanos, Mint_Loggo_TimePrecision precision);
+
+// Time
+static uint64_t Mint_Loggo_RealtimeNs();
+static uint64_t Mint_Loggo_MonotonicMs();
+static uint64_t Mint_Loggo_ReadCycles();
+static bool Mint_Loggo_CyclesInvariant();
+static bool Mint_Loggo_CalibrateCycles(Mint_Loggo_CycleClock* clock);
+static void Mint_Loggo_MeasureCycles();
+static uint64_t Mint_Loggo_Now(Mint_Loggo_LogFormat* format);
+
+// Latency
+#ifdef MINT_LOGGO_LATENCY_STATS
+static uint64_t Mint_Loggo_MonotonicNs();
+static uint32_t Mint_Loggo_LatencyBucket(uint64_t value);
+static uint64_t Mint_Loggo_LatencyBucketTop(uint32_t bucket);
+static void Mint_Loggo_RecordLatency(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message);
+static void Mint_Loggo_SummarizeLatency(Mint_Loggo_LatencyStats* stats, Mint_Loggo_LatencyStage stage, Mint_Loggo_LatencySummary* summary);
+static void Mint_Loggo_EmitLatencyReport(Mint_Loggo_Logger* logger);
+#endif
+
+// Context
+static Mint_Loggo_Context* Mint_Loggo_ContextAcquire();
+static void Mint_Loggo_ContextRelease(Mint_Loggo_Context* context);
+static void Mint_Loggo_ContextRender(Mint_Loggo_ThreadContext* thread);
+static uint64_t Mint_Loggo_StampToNs(Mint_Loggo_Logger* logger, uint64_t stamp);
 
 // Hash Table
 static Mint_Loggo_Logger* Mint_Loggo_HTFindItem(const char* name);
-static int32_t Mint_Loggo_HTInsertItem(const char* name, Mint_Loggo_Logger* logger);
-static void Mint_Loggo_HTDeleteItem(const char* name);
+static int32_t Mint_Loggo_HTInsertItem(const char* name, Mint_Loggo_Logger* logger, Mint_Loggo_Logger** replaced);
+static Mint_Loggo_Logger* Mint_Loggo_HTDeleteItem(const char* name);
 static void Mint_Loggo_HTResizeTable();
 static void Mint_Loggo_HTInitTable();
+static void Mint_Loggo_HTReserve(int32_t count);
 static void Mint_Loggo_HTDeleteTable();
 static int32_t Mint_Loggo_StringHash(const char* name, const int32_t prime, const int32_t buckets);
-static int32_t Mint_Loggo_LoggerStringHash(const char* name, const int32_t buckets, const int32_t attempt);
+static void Mint_Loggo_HTProbe(const char* name, const int32_t buckets, uint32_t* start, uint32_t* step);
+static void Mint_Loggo_HTRehash(int32_t capacity);
+static void Mint_Loggo_HTRetire(void* memory);
+static void Mint_Loggo_HTReclaim();
+static void Mint_Loggo_HTSynchronize();
+static void Mint_Loggo_LockRegistry();
+static void Mint_Loggo_UnlockRegistry();
+
+// Socket sink
+#ifdef MINT_LOGGO_HAS_SOCKETS
+static bool Mint_Loggo_SocketConnect(Mint_Loggo_SocketSink* sink);
+static void Mint_Loggo_SocketDisconnect(Mint_Loggo_SocketSink* sink);
+static void Mint_Loggo_SocketSend(Mint_Loggo_SocketSink* sink, bool include_open, bool blocking);
+static void Mint_Loggo_SocketPopFrame(Mint_Loggo_SocketSink* sink);
+#endif
+
+// File sink
+static void Mint_Loggo_FileCloseChunk(Mint_Loggo_FileSink* sink);
+static void Mint_Loggo_FileReopen(Mint_Loggo_FileSink* sink);
+static void Mint_Loggo_FileCoverGap(Mint_Loggo_FileSink* sink, const Mint_Loggo_FileConfig* config);
+static void Mint_Loggo_FileAppendBlock(Mint_Loggo_FileSink* sink, const char* text, size_t len);
+static void Mint_Loggo_FileEmitFrame(Mint_Loggo_FileSink* sink);
 
 
 
@@ -460,75 +1500,343 @@ MINT_LOGGO_DEF int32_t Mint_Loggo_CreateLogger(const char* name, Mint_Loggo_LogF
         return -1;
     }
 
-    Mint_Loggo_HTInitTable();
-
-    Mint_Loggo_Logger* logger = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_Logger));
-    memset(logger, 0U, sizeof(*logger));
-
-    // Fill up with info
-    logger->handler = Mint_Loggo_CreateLogHandler(user_handler);
-
-    // Clean up and return -1
-    if (!logger->handler) {
-        Mint_Loggo_DestroyLogHandler(logger->handler);
-        memset(logger, 0U, sizeof(*logger));
-        MINT_LOGGO_FREE(logger);
-        logger = NULL;
-        return  -1;
+    Mint_Loggo_Logger* logger = Mint_Loggo_MakeLogger(name, user_format, user_handler);
+    if (!logger) {
+        return -1;
     }
 
-    logger->format = Mint_Loggo_CreateLogFormat(user_format);
-    logger->name = name;
-    logger->queue = Mint_Loggo_CreateQueue(logger->format->queue_capacity);
+    // Spin up a thread for the loggers, lazy ones wait for their first message
+    // Started before it is published so nobody else ever sees it half made, under the lock so a fork
+    // cant catch a thread that isnt in the table yet
+    Mint_Loggo_LockRegistry();
+    if (!logger->format->lazy) {
+        Mint_Loggo_StartLogger(logger);
+    }
 
     // Handle the string allocation to a logger id
-    int32_t id = Mint_Loggo_HTInsertItem(name, logger);
+    Mint_Loggo_HTInitTable();
+    Mint_Loggo_Logger* replaced = NULL;
+    int32_t id = Mint_Loggo_HTInsertItem(name, logger, &replaced);
 
-    // We failed
+    // We failed, nothing saw it so it is stopped like one that was deleted
     if (id == -1) {
-        Mint_Loggo_DestroyLogFormat(logger->format);
-        Mint_Loggo_DestroyLogHandler(logger->handler);
-        Mint_Loggo_DestroyQueue(logger->queue);
-        memset(logger, 0U, sizeof(*logger));
-        MINT_LOGGO_FREE(logger);
-        logger = NULL;
+        Mint_Loggo_UnlockRegistry();
+        Mint_Loggo_CleanUpLogger(logger);
         return  id;
     }
 
     // Handle new stuff
-    logger->id = id;
+    Mint_Loggo_ResolveLevels();
+    Mint_Loggo_UnlockRegistry();
 
-    // Spin up a thread for the loggers
-    MINT_LOGGO_THREAD_CREATE(&logger->thread_id, Mint_Loggo_RunLogger, ((void*)logger));
+    // The logger it replaced is stopped without the lock
+    if (replaced) {
+        Mint_Loggo_CleanUpLogger(replaced);
+    }
 
     // Return Id to user
-    return logger->id;
+    return id;
 }
 
 
-// Shutdown the loggers by iterating and setting values
-MINT_LOGGO_DEF void Mint_Loggo_DeleteLoggers() {
-    for (int32_t idx = 0; idx < MINT_LOGGO_LOGGER_HASH_TABLE.capacity; idx++) {
-        // Delete non null items by grabbing there names from the table
-        if (MINT_LOGGO_LOGGER_HASH_TABLE.loggers[idx] != NULL && MINT_LOGGO_LOGGER_HASH_TABLE.loggers[idx] != &MINT_LOGGO_LOGGER_DELETED) {
-            Mint_Loggo_HTDeleteItem(MINT_LOGGO_LOGGER_HASH_TABLE.loggers[idx]->name);
+// Children share everything with the ancestor that owns a thread, only the name and level are theirs
+MINT_LOGGO_DEF int32_t Mint_Loggo_CreateChild(const char* name) {
+    #ifdef MINT__DEBUG
+        assert(name);
+    #endif
+
+    if (!name) {
+        return -1;
+    }
+
+    Mint_Loggo_LockRegistry();
+    Mint_Loggo_HTInitTable();
+
+    // An owner on its way out takes its children with it, no new ones
+    Mint_Loggo_Logger* parent = Mint_Loggo_FindAncestor(name);
+    if (!parent || Mint_Loggo_OwnerOf(parent)->unlinked) {
+        Mint_Loggo_UnlockRegistry();
+        return -1;
+    }
+
+    Mint_Loggo_Logger* logger = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_Logger));
+    memset(logger, 0U, sizeof(*logger));
+    logger->owner = Mint_Loggo_OwnerOf(parent);
+    logger->format = logger->owner->format;
+    logger->allocator = logger->owner->allocator;
+    logger->name = name;
+    logger->own_level = -1;
+    logger->level = parent->level;
+
+    Mint_Loggo_Logger* replaced = NULL;
+    int32_t id = Mint_Loggo_HTInsertItem(name, logger, &replaced);
+    if (id == -1) {
+        MINT_LOGGO_FREE(logger);
+    } else {
+        Mint_Loggo_ResolveLevels();
+    }
+
+    Mint_Loggo_UnlockRegistry();
+    if (replaced) {
+        Mint_Loggo_CleanUpLogger(replaced);
+    }
+    return id;
+}
+
+
+// Create every logger in the table, rolling the whole table back if one fails
+MINT_LOGGO_DEF int32_t Mint_Loggo_RegisterLoggers(const Mint_Loggo_LoggerDecl* loggers, size_t count) {
+    #ifdef MINT__DEBUG
+        assert(loggers);
+    #endif
+
+    // Everything that can fail is made first, the names are then checked and taken in one go so
+    // nothing created meanwhile is replaced
+    Mint_Loggo_Logger** made = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_Logger*) * (count ? count : 1U));
+    size_t ready = 0U;
+    for (; ready < count; ready++) {
+        Mint_Loggo_LogFormat format = {0};
+        if (loggers[ready].format) {
+            format = *loggers[ready].format;
+        }
+        format.lazy = true;
+
+        made[ready] = loggers[ready].name ? Mint_Loggo_MakeLogger(loggers[ready].name, &format, loggers[ready].handler) : NULL;
+        if (!made[ready]) {
+            break;
+        }
+    }
+
+    Mint_Loggo_LockRegistry();
+    bool taken = ready < count;
+    for (size_t idx = 0U; !taken && idx < count; idx++) {
+        taken = Mint_Loggo_HTFindItem(loggers[idx].name) != NULL;
+        for (size_t other = 0U; !taken && other < idx; other++) {
+            taken = strcmp(loggers[idx].name, loggers[other].name) == 0;
+        }
+    }
+
+    // Reserved up front so no insert can fail halfway through
+    if (!taken) {
+        Mint_Loggo_HTInitTable();
+        Mint_Loggo_HTReserve(MINT_LOGGO_LOGGER_HASH_TABLE.size + (int32_t)count);
+        for (size_t idx = 0U; idx < count; idx++) {
+            Mint_Loggo_Logger* replaced = NULL;
+            Mint_Loggo_HTInsertItem(loggers[idx].name, made[idx], &replaced);
+        }
+        Mint_Loggo_ResolveLevels();
+    } else {
+        for (size_t idx = 0U; idx < ready; idx++) {
+            Mint_Loggo_FreeLogger(made[idx]);
+        }
+
+        // Nobody could have looked them up, without a table nothing else will reclaim them
+        if (!MINT_LOGGO_LOGGER_HASH_TABLE.loggers) {
+            Mint_Loggo_HTReclaim();
         }
     }
+    Mint_Loggo_UnlockRegistry();
 
-    Mint_Loggo_HTDeleteTable();
-    memset(&MINT_LOGGO_LOGGER_HASH_TABLE, 0U, sizeof(Mint_Loggo_HashTable));
+    MINT_LOGGO_FREE(made);
+    return taken ? -1 : 0;
 }
 
 
-// Shutdown the loggers by iterating and setting values
-MINT_LOGGO_DEF void Mint_Loggo_DeleteLogger(const char* name) {
-    Mint_Loggo_HTDeleteItem(name);
+// Shutdown the loggers, everything queued is written
+MINT_LOGGO_DEF void Mint_Loggo_DeleteLoggers() {
+    Mint_Loggo_Shutdown(0U);
+}
 
-    // Just delete the table and clear it so its inited next time
-    if (MINT_LOGGO_LOGGER_HASH_TABLE.size == 0) {
+
+// Close every queue first so the loggers drain in parallel, then collect them
+// Owners leave the table first so the waiting is done without the registry lock, children stay
+// until their owner is gone
+MINT_LOGGO_DEF uint64_t Mint_Loggo_Shutdown(uint32_t deadline_ms) {
+    Mint_Loggo_HashTable* table = &MINT_LOGGO_LOGGER_HASH_TABLE;
+    uint64_t dropped = 0U;
+    Mint_Loggo_LockRegistry();
+    if (!table->loggers) {
+        Mint_Loggo_UnlockRegistry();
+        return dropped;
+    }
+
+    Mint_Loggo_Logger** owners = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_Logger*) * (size_t)table->capacity);
+    int32_t count = 0;
+    for (int32_t idx = 0; idx < table->capacity; idx++) {
+        Mint_Loggo_Logger* logger = table->loggers[idx];
+        if (logger && logger != &MINT_LOGGO_LOGGER_DELETED && !logger->owner) {
+            MINT_LOGGO_ATOMIC_STORE(&table->loggers[idx], &MINT_LOGGO_LOGGER_DELETED);
+            table->size--;
+            table->deleted++;
+            owners[count++] = Mint_Loggo_UnlinkLogger(logger);
+        }
+    }
+    Mint_Loggo_UnlockRegistry();
+
+    for (int32_t idx = 0; idx < count; idx++) {
+        if (owners[idx]->state == MINT_LOGGO_LOGGER_RUNNING) {
+            Mint_Loggo_CloseQueue(owners[idx]->queue);
+        }
+    }
+
+    // Nothing else will drain a threadless logger, chunks keep the deadline meaningful
+    // A setter drains one on its own thread so it is let finish first
+    uint64_t deadline = Mint_Loggo_MonotonicMs() + deadline_ms;
+    for (int32_t idx = 0; idx < count; idx++) {
+        Mint_Loggo_Logger* logger = owners[idx];
+        if (logger->state == MINT_LOGGO_LOGGER_RUNNING && logger->format->threadless) {
+            Mint_Loggo_WaitForHolds(logger);
+            while (Mint_Loggo_DrainLogger(logger, MINT_LOGGO_DEFAULT_QUEUE_SIZE) && (deadline_ms == 0U || Mint_Loggo_MonotonicMs() < deadline)) {}
+            Mint_Loggo_FinishOutput(logger);
+            MINT_LOGGO_ATOMIC_STORE(&logger->exited, 1U);
+        }
+    }
+
+    // Wait for the slowest sink or the deadline, whichever is first
+    Mint_Loggo_WaitForExits(owners, count, deadline_ms ? deadline : 0U);
+
+    // Past the deadline, the stragglers stop after the message they are on and get a moment to do so
+    bool stragglers = false;
+    for (int32_t idx = 0; idx < count; idx++) {
+        if (owners[idx]->state == MINT_LOGGO_LOGGER_RUNNING && !MINT_LOGGO_ATOMIC_LOAD(&owners[idx]->exited)) {
+            MINT_LOGGO_ATOMIC_STORE(&owners[idx]->abandon, 1U);
+            stragglers = true;
+        }
+    }
+    if (stragglers) {
+        Mint_Loggo_WaitForExits(owners, count, Mint_Loggo_MonotonicMs() + 1U);
+    }
+
+    // Setters still holding a logger that stopped are done by now, their change was made or refused
+    Mint_Loggo_LockRegistry();
+    for (int32_t idx = 0; idx < count; idx++) {
+        Mint_Loggo_Logger* logger = owners[idx];
+        if (logger->state != MINT_LOGGO_LOGGER_RUNNING || MINT_LOGGO_ATOMIC_LOAD(&logger->exited)) {
+            Mint_Loggo_WaitForHolds(logger);
+        }
+
+        if (logger->state != MINT_LOGGO_LOGGER_RUNNING) {
+            Mint_Loggo_DropChildren(logger, true);
+            Mint_Loggo_FreeLogger(logger);
+        } else if (MINT_LOGGO_ATOMIC_LOAD(&logger->exited)) {
+            if (!logger->format->threadless) {
+                MINT_LOGGO_THREAD_JOIN(logger->thread_id);
+            }
+            dropped += logger->abandoned + Mint_Loggo_DropQueued(logger);
+            Mint_Loggo_DropChildren(logger, true);
+            Mint_Loggo_FreeLogger(logger);
+        } else {
+            // Still blocked in its sink, everything it owns has to stay alive, its children included
+            dropped += MINT_LOGGO_ATOMIC_LOAD(&logger->queue->size);
+            MINT_LOGGO_THREAD_DETACH(logger->thread_id);
+            Mint_Loggo_DropChildren(logger, false);
+        }
+    }
+    MINT_LOGGO_FREE(owners);
+
+    // Loggers made meanwhile, or children of one a delete is still stopping, keep the table
+    if (table->size == 0) {
         Mint_Loggo_HTDeleteTable();
         memset(&MINT_LOGGO_LOGGER_HASH_TABLE, 0U, sizeof(Mint_Loggo_HashTable));
+        Mint_Loggo_CloseEventFd();
+    } else {
+        Mint_Loggo_ResolveLevels();
+    }
+    Mint_Loggo_UnlockRegistry();
+    return dropped;
+}
+
+
+// Children go right away, an owner is taken out of the table and stopped without the lock
+MINT_LOGGO_DEF void Mint_Loggo_DeleteLogger(const char* name) {
+    Mint_Loggo_LockRegistry();
+    if (!MINT_LOGGO_LOGGER_HASH_TABLE.loggers) {
+        Mint_Loggo_UnlockRegistry();
+        return;
+    }
+    Mint_Loggo_Logger* logger = Mint_Loggo_HTDeleteItem(name);
+    Mint_Loggo_ResolveLevels();
+    Mint_Loggo_UnlockRegistry();
+
+    if (logger) {
+        Mint_Loggo_CleanUpLogger(logger);
+    }
+}
+
+
+// Descendants are resolved here so the check on the logging path stays a single load
+// Looked up under the registry lock so a delete cant free the logger between the lookup and the write
+MINT_LOGGO_DEF bool Mint_Loggo_SetLevel(const char* name, Mint_Loggo_LogLevel level) {
+    Mint_Loggo_LockRegistry();
+    Mint_Loggo_Logger* logger = Mint_Loggo_HTFindItem(name);
+    if (!logger) {
+        Mint_Loggo_UnlockRegistry();
+        return false;
+    }
+
+    logger->own_level = (int32_t)level;
+    Mint_Loggo_ResolveLevels();
+    Mint_Loggo_UnlockRegistry();
+    return true;
+}
+
+
+MINT_LOGGO_DEF bool Mint_Loggo_InheritLevel(const char* name) {
+    Mint_Loggo_LockRegistry();
+    Mint_Loggo_Logger* logger = Mint_Loggo_HTFindItem(name);
+    if (!logger) {
+        Mint_Loggo_UnlockRegistry();
+        return false;
+    }
+
+    logger->own_level = -1;
+    Mint_Loggo_ResolveLevels();
+    Mint_Loggo_UnlockRegistry();
+    return true;
+}
+
+
+// The logger is held so a delete waits for the caller before freeing it
+MINT_LOGGO_DEF bool Mint_Loggo_SetFlush(const char* name, bool flush) {
+    Mint_Loggo_Logger* logger = Mint_Loggo_HoldOwner(name);
+    if (!logger) {
+        return false;
+    }
+
+    MINT_LOGGO_ATOMIC_STORE(&logger->format->flush, flush);
+    Mint_Loggo_LetGo(logger);
+    return true;
+}
+
+
+// Colors are baked into the line pieces so the logger thread rebuilds them
+MINT_LOGGO_DEF bool Mint_Loggo_SetColors(const char* name, bool colors) {
+    Mint_Loggo_Logger* logger = Mint_Loggo_HoldOwner(name);
+    if (!logger) {
+        return false;
+    }
+
+    bool applied = Mint_Loggo_QueueReconfigure(logger, NULL, colors ? 1 : 0);
+    Mint_Loggo_LetGo(logger);
+    return applied;
+}
+
+
+MINT_LOGGO_DEF bool Mint_Loggo_SetHandler(const char* name, Mint_Loggo_LogHandler* user_handler) {
+    Mint_Loggo_LogHandler* handler = Mint_Loggo_CreateLogHandler(user_handler);
+    if (!handler) {
+        return false;
+    }
+
+    Mint_Loggo_Logger* logger = Mint_Loggo_HoldOwner(name);
+    bool applied = logger && Mint_Loggo_QueueReconfigure(logger, handler, -1);
+    if (logger) {
+        Mint_Loggo_LetGo(logger);
     }
+    if (!applied) {
+        Mint_Loggo_DestroyLogHandler(handler);
+    }
+    return applied;
 }
 
 
@@ -548,10 +1856,14 @@ MINT_LOGGO_DEF void Mint_Loggo_Log(const char* name, Mint_Loggo_LogLevel level,
         exit(EXIT_FAILURE);
     }
 
-    Mint_Loggo_LogMessage* message = Mint_Loggo_CreateLogMessage(logger, level, msg);
+    if (level < MINT_LOGGO_ATOMIC_LOAD(&logger->level)) {
+        return;
+    }
+    Mint_Loggo_WakeLogger(logger);
 
+    Mint_Loggo_LogMessage* message = Mint_Loggo_CreateLogMessage(logger, level, msg);
 
-    Mint_Loggo_Enqueue(logger->queue, message);
+    Mint_Loggo_Submit(logger, message);
 }
 
 
@@ -572,20 +1884,316 @@ MINT_LOGGO_DEF void Mint_Loggo_Log2(const char* name, Mint_Loggo_LogLevel level,
         exit(EXIT_FAILURE);
     }
 
+    // Owned strings are adopted instead of copied
+    if (free_string) {
+        Mint_Loggo_LogMove(name, level, msg);
+        return;
+    }
+
+    if (level < MINT_LOGGO_ATOMIC_LOAD(&logger->level)) {
+        return;
+    }
+    Mint_Loggo_WakeLogger(logger);
+
     Mint_Loggo_LogMessage* message = Mint_Loggo_CreateLogMessage(logger, level, msg);
+    Mint_Loggo_Submit(logger, message);
+}
 
-    if (free_string) {
+
+// Only the message header is allocated, msg rides along and is freed by the logger thread
+MINT_LOGGO_DEF void Mint_Loggo_LogMove(const char* name, Mint_Loggo_LogLevel level, char* msg) {
+    #ifdef MINT__DEBUG
+        assert(name);
+        assert(msg);
+    #endif
+
+    Mint_Loggo_Logger* logger = Mint_Loggo_HTFindItem(name);
+
+    if (!logger) {
+        fprintf(stderr, "Invalid Logger Name: %s\n", name);
+        Mint_Loggo_DeleteLoggers();
+        exit(EXIT_FAILURE);
+    }
+
+    if (level < MINT_LOGGO_ATOMIC_LOAD(&logger->level)) {
         free(msg);
+        return;
+    }
+    Mint_Loggo_WakeLogger(logger);
+
+    Mint_Loggo_LogMessage* message = Mint_Loggo_AllocMessage(logger, sizeof(Mint_Loggo_LogMessage));
+    memset(message, 0U, sizeof(*message));
+    message->level = level;
+    message->adopted = true;
+    message->timestamp = Mint_Loggo_Now(logger->format);
+    message->thread_id = Mint_Loggo_ThreadId();
+    message->context = Mint_Loggo_ContextAcquire();
+    message->msg = msg;
+    Mint_Loggo_Submit(logger, message);
+}
+
+
+// Header only like LogMove, but the text is neither measured nor freed
+MINT_LOGGO_DEF void Mint_Loggo_LogStatic(const char* name, Mint_Loggo_LogLevel level, const char* msg, size_t len) {
+    #ifdef MINT__DEBUG
+        assert(name);
+        assert(msg);
+    #endif
+
+    Mint_Loggo_Logger* logger = Mint_Loggo_HTFindItem(name);
+
+    if (!logger) {
+        fprintf(stderr, "Invalid Logger Name: %s\n", name);
+        Mint_Loggo_DeleteLoggers();
+        exit(EXIT_FAILURE);
+    }
+
+    if (level < MINT_LOGGO_ATOMIC_LOAD(&logger->level)) {
+        return;
+    }
+    Mint_Loggo_WakeLogger(logger);
+
+    Mint_Loggo_LogMessage* message = Mint_Loggo_AllocMessage(logger, sizeof(Mint_Loggo_LogMessage));
+    memset(message, 0U, sizeof(*message));
+    message->level = level;
+    message->borrowed = true;
+    message->timestamp = Mint_Loggo_Now(logger->format);
+    message->thread_id = Mint_Loggo_ThreadId();
+    message->context = Mint_Loggo_ContextAcquire();
+    message->msg = (char*)msg;
+    message->msg_len = len;
+    Mint_Loggo_Submit(logger, message);
+}
+
+
+// Reserve a message with room for the payload, nothing is allocated for filtered levels
+MINT_LOGGO_DEF Mint_Loggo_Deferred Mint_Loggo_BeginDeferred(const char* name, Mint_Loggo_LogLevel level, Mint_Loggo_FormatFn formatter, size_t payload_size) {
+    #ifdef MINT__DEBUG
+        assert(name);
+        assert(formatter);
+    #endif
+
+    Mint_Loggo_Deferred deferred = {0};
+    Mint_Loggo_Logger* logger = Mint_Loggo_HTFindItem(name);
+
+    if (!logger) {
+        fprintf(stderr, "Invalid Logger Name: %s\n", name);
+        Mint_Loggo_DeleteLoggers();
+        exit(EXIT_FAILURE);
+    }
+
+    if (level < MINT_LOGGO_ATOMIC_LOAD(&logger->level)) {
+        return deferred;
+    }
+    Mint_Loggo_WakeLogger(logger);
+
+    Mint_Loggo_LogMessage* message = Mint_Loggo_AllocMessage(logger, MINT_LOGGO_MESSAGE_HEADER_SIZE + payload_size);
+    memset(message, 0U, sizeof(*message));
+    message->level = level;
+    message->timestamp = Mint_Loggo_Now(logger->format);
+    message->thread_id = Mint_Loggo_ThreadId();
+    message->context = Mint_Loggo_ContextAcquire();
+    message->formatter = formatter;
+    message->payload = (char*)message + MINT_LOGGO_MESSAGE_HEADER_SIZE;
+
+    deferred.payload = message->payload;
+    deferred.message = message;
+    deferred.logger = logger;
+    return deferred;
+}
+
+
+// Hand the filled in message to the logger thread
+MINT_LOGGO_DEF void Mint_Loggo_CommitDeferred(Mint_Loggo_Deferred deferred) {
+    if (!deferred.payload) {
+        return;
+    }
+
+    Mint_Loggo_Logger* logger = deferred.logger;
+    Mint_Loggo_Submit(logger, deferred.message);
+}
+
+
+MINT_LOGGO_DEF void Mint_Loggo_TraceBegin(const char* name, const char* span) {
+    Mint_Loggo_Trace(name, MINT_LOGGO_MESSAGE_TRACE_BEGIN, span);
+}
+
+
+MINT_LOGGO_DEF void Mint_Loggo_TraceEnd(const char* name, const char* span) {
+    Mint_Loggo_Trace(name, MINT_LOGGO_MESSAGE_TRACE_END, span);
+}
+
+
+MINT_LOGGO_DEF void Mint_Loggo_TraceInstant(const char* name, const char* event) {
+    Mint_Loggo_Trace(name, MINT_LOGGO_MESSAGE_TRACE_INSTANT, event);
+}
+
+
+// Syscalls only happen the first time a thread asks
+// A forked child clears it, the forking thread gets a new id there
+MINT_LOGGO_DEF uint64_t Mint_Loggo_ThreadId() {
+    if (!MINT_LOGGO_THREAD_ID) {
+        #if defined(__linux__)
+            MINT_LOGGO_THREAD_ID = (uint64_t)syscall(SYS_gettid);
+        #elif defined(__APPLE__)
+            pthread_threadid_np(NULL, &MINT_LOGGO_THREAD_ID);
+        #elif defined(_WIN32)
+            MINT_LOGGO_THREAD_ID = (uint64_t)GetCurrentThreadId();
+        #else
+            MINT_LOGGO_THREAD_ID = (uint64_t)(uintptr_t)pthread_self();
+        #endif
+    }
+    return MINT_LOGGO_THREAD_ID;
+}
+
+
+// Context
+
+
+MINT_LOGGO_DEF bool Mint_Loggo_ContextSet(const char* key, const char* value) {
+    #ifdef MINT__DEBUG
+        assert(key);
+    #endif
+
+    Mint_Loggo_ThreadContext* thread = &MINT_LOGGO_THREAD_CONTEXT;
+    uint32_t idx = 0U;
+    while (idx < thread->count && strcmp(thread->keys[idx], key) != 0) {
+        idx++;
+    }
+
+    if (idx < thread->count) {
+        MINT_LOGGO_FREE(thread->values[idx]);
+        if (value) {
+            Mint_Loggo_MakePiece(&thread->values[idx], value, "", "");
+        } else {
+            // Keep the rest in the order they were set
+            MINT_LOGGO_FREE(thread->keys[idx]);
+            memmove(&thread->keys[idx], &thread->keys[idx + 1U], sizeof(char*) * (thread->count - idx - 1U));
+            memmove(&thread->values[idx], &thread->values[idx + 1U], sizeof(char*) * (thread->count - idx - 1U));
+            thread->count--;
+        }
+    } else if (value) {
+        if (thread->count == MINT_LOGGO_CONTEXT_FIELDS) {
+            return false;
+        }
+        Mint_Loggo_MakePiece(&thread->keys[thread->count], key, "", "");
+        Mint_Loggo_MakePiece(&thread->values[thread->count], value, "", "");
+        thread->count++;
+    }
+
+    Mint_Loggo_ContextRender(thread);
+    return true;
+}
+
+
+MINT_LOGGO_DEF void Mint_Loggo_ContextClear() {
+    Mint_Loggo_ThreadContext* thread = &MINT_LOGGO_THREAD_CONTEXT;
+    for (uint32_t idx = 0; idx < thread->count; idx++) {
+        MINT_LOGGO_FREE(thread->keys[idx]);
+        MINT_LOGGO_FREE(thread->values[idx]);
+    }
+    thread->count = 0U;
+    Mint_Loggo_ContextRender(thread);
+}
+
+
+// Lay out both renderings in one block, messages still holding the old one keep it alive
+static void Mint_Loggo_ContextRender(Mint_Loggo_ThreadContext* thread) {
+    if (thread->current) {
+        Mint_Loggo_ContextRelease(thread->current);
+        thread->current = NULL;
+    }
+
+    if (thread->count == 0U) {
+        return;
+    }
+
+    size_t text_len = 0U;
+    size_t json_len = 0U;
+    for (uint32_t idx = 0; idx < thread->count; idx++) {
+        size_t pair = strlen(thread->keys[idx]) + strlen(thread->values[idx]);
+        text_len += pair + 2U;
+        json_len += pair * 6U + 6U;
+    }
+
+    // Escaping grows text at most as much as JSON does, stripping only shrinks it
+    Mint_Loggo_Context* context = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_Context) + 2U * text_len + 2U * json_len + 4U);
+    context->refs = 1U;
+    context->text = (char*)(context + 1);
+    context->stripped = context->text + text_len + 1U;
+    context->escaped = context->stripped + text_len + 1U;
+    context->json = context->escaped + json_len + 1U;
+
+    char* text = context->text;
+    char* escaped = context->escaped;
+    char* stripped = context->stripped;
+    char* json = context->json;
+    for (uint32_t idx = 0; idx < thread->count; idx++) {
+        const char* key = thread->keys[idx];
+        const char* value = thread->values[idx];
+        size_t key_len = strlen(key);
+        size_t value_len = strlen(value);
+        text += sprintf(text, "%s=%s ", key, value);
+
+        // Keys and values are escaped once here instead of on every line
+        escaped += Mint_Loggo_SanitizeCopy(escaped, key, key_len, MINT_LOGGO_SANITIZE_ESCAPE, false);
+        *escaped++ = '=';
+        escaped += Mint_Loggo_SanitizeCopy(escaped, value, value_len, MINT_LOGGO_SANITIZE_ESCAPE, false);
+        *escaped++ = ' ';
+
+        stripped += Mint_Loggo_SanitizeCopy(stripped, key, key_len, MINT_LOGGO_SANITIZE_STRIP, false);
+        *stripped++ = '=';
+        stripped += Mint_Loggo_SanitizeCopy(stripped, value, value_len, MINT_LOGGO_SANITIZE_STRIP, false);
+        *stripped++ = ' ';
+
+        json += sprintf(json, ",\"");
+        json += Mint_Loggo_SanitizeCopy(json, key, key_len, MINT_LOGGO_SANITIZE_ESCAPE, true);
+        json += sprintf(json, "\":\"");
+        json += Mint_Loggo_SanitizeCopy(json, value, value_len, MINT_LOGGO_SANITIZE_ESCAPE, true);
+        *json++ = '"';
+    }
+    *escaped = '\0';
+    *stripped = '\0';
+    *json = '\0';
+    context->text_len = (uint32_t)(text - context->text);
+    context->escaped_len = (uint32_t)(escaped - context->escaped);
+    context->stripped_len = (uint32_t)(stripped - context->stripped);
+    context->json_len = (uint32_t)(json - context->json);
+    thread->current = context;
+}
+
+
+// One reference per message, the thread holds one for as long as the rendering is current
+static Mint_Loggo_Context* Mint_Loggo_ContextAcquire() {
+    Mint_Loggo_Context* context = MINT_LOGGO_THREAD_CONTEXT.current;
+    if (context) {
+        MINT_LOGGO_ATOMIC_ADD(&context->refs, 1U);
+    }
+    return context;
+}
+
+
+static void Mint_Loggo_ContextRelease(Mint_Loggo_Context* context) {
+    if (MINT_LOGGO_ATOMIC_ADD(&context->refs, -1) == 0U) {
+        MINT_LOGGO_FREE(context);
     }
-    
-    Mint_Loggo_Enqueue(logger->queue, message);
 }
 
 
 // Queue
 
-// Create the queue with sane defaults
-static Mint_Loggo_LogQueue* Mint_Loggo_CreateQueue(uint32_t capacity) {
+// Tell the logger thread to stop once the queue is empty, this never blocks on a full queue
+static void Mint_Loggo_CloseQueue(Mint_Loggo_LogQueue* queue) {
+    MINT_LOGGO_MUTEX_LOCK(queue->queue_lock);
+    MINT_LOGGO_ATOMIC_STORE(&queue->closed, true);
+    MINT_LOGGO_COND_SIGNAL(queue->queue_not_empty);
+    MINT_LOGGO_COND_BROADCAST(queue->queue_not_full);
+    MINT_LOGGO_MUTEX_UNLOCK(queue->queue_lock);
+}
+
+
+// Create the queue with sane defaults, a zero urgent capacity leaves the queue with just the bulk lane
+static Mint_Loggo_LogQueue* Mint_Loggo_CreateQueue(uint32_t capacity, uint32_t urgent_capacity) {
     #ifdef MINT__DEBUG
         assert(capacity > 0U);
     #endif
@@ -594,9 +2202,6 @@ static Mint_Loggo_LogQueue* Mint_Loggo_CreateQueue(uint32_t capacity) {
 
     // Clear out values and set actual ones
     memset(queue, 0U, sizeof(*queue));
-    queue->capacity = capacity;
-    queue->head = 0U;
-    queue->tail = 0U;
     queue->size = 0U;
 
     // Init locks/cond
@@ -604,9 +2209,18 @@ static Mint_Loggo_LogQueue* Mint_Loggo_CreateQueue(uint32_t capacity) {
     MINT_LOGGO_COND_INIT(queue->queue_not_full);
     MINT_LOGGO_COND_INIT(queue->queue_not_empty);
 
-    // Init messsages circular buffer
-    queue->messages = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_LogMessage*) * queue->capacity);
-    memset(queue->messages, 0U, sizeof(Mint_Loggo_LogMessage*) * queue->capacity);
+    // Init messsages circular buffers
+    uint32_t capacities[MINT_LOGGO_LANES] = {capacity, urgent_capacity};
+    for (int32_t idx = 0; idx < MINT_LOGGO_LANES; idx++) {
+        Mint_Loggo_LogLane* lane = &queue->lanes[idx];
+        lane->capacity = capacities[idx];
+        lane->head = 0U;
+        lane->tail = 0U;
+        if (lane->capacity) {
+            lane->messages = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_LogMessage*) * lane->capacity);
+            memset(lane->messages, 0U, sizeof(Mint_Loggo_LogMessage*) * lane->capacity);
+        }
+    }
     return queue;
 }
 
@@ -617,22 +2231,19 @@ static void Mint_Loggo_DestroyQueue(Mint_Loggo_LogQueue* queue) {
         assert(queue);
     #endif
 
-    // Safer to go over all of them just in case and free shit,
-    // The terminate in the thread loop should do this
-    uint32_t start = queue->tail;
-    uint32_t end = queue->head;
-    while(start != end) {
-        if(queue->messages[start]) {
-            if (queue->messages[start]->msg) {
-                MINT_LOGGO_FREE(queue->messages[start]->msg);
-                queue->messages[start]->msg = NULL;
-            }
-            MINT_LOGGO_FREE(queue->messages[start]);
-            queue->messages[start] = NULL;
+    // Messages belong to the logger's pool or allocator, DropQueued hands them back before this
+    #ifdef MINT__DEBUG
+        assert(queue->size == 0U);
+    #endif
+
+    for (int32_t idx = 0; idx < MINT_LOGGO_LANES; idx++) {
+        Mint_Loggo_LogLane* lane = &queue->lanes[idx];
+
+        // Free messages that the queue owns
+        if (lane->messages) {
+            MINT_LOGGO_FREE(lane->messages);
+            lane->messages = NULL;
         }
-        
-        // Wraparound
-        start = (start + 1) % queue->capacity;
     }
 
     // Clean up threading stuff
@@ -640,12 +2251,6 @@ static void Mint_Loggo_DestroyQueue(Mint_Loggo_LogQueue* queue) {
     MINT_LOGGO_COND_DESTROY((queue->queue_not_empty));
     MINT_LOGGO_COND_DESTROY((queue->queue_not_full));
 
-    // Free messages that the queue owns
-    if (queue->messages) {
-        MINT_LOGGO_FREE(queue->messages);
-        queue->messages = NULL;
-    }
-
     // Clean up last bits of memory
     memset(queue, 0U, sizeof(*queue));
     MINT_LOGGO_FREE(queue);
@@ -653,41 +2258,108 @@ static void Mint_Loggo_DestroyQueue(Mint_Loggo_LogQueue* queue) {
 
 
 // If head + 1 == tail
-static bool Mint_Loggo_IsQueueFull(Mint_Loggo_LogQueue* queue) {
-    return queue->head + 1 == queue->tail;
+static bool Mint_Loggo_IsLaneFull(Mint_Loggo_LogLane* lane) {
+    return (lane->head + 1U) % lane->capacity == lane->tail;
 }
 
  
 // If head == tail
-static bool Mint_Loggo_IsQueueEmpty(Mint_Loggo_LogQueue* queue) {
-    return queue->head == queue->tail;
+static bool Mint_Loggo_IsLaneEmpty(Mint_Loggo_LogLane* lane) {
+    return lane->head == lane->tail;
 }
 
 
-// Wait for the queue to not be full
-// Add message
+// Both lanes are empty
+static bool Mint_Loggo_IsQueueEmpty(Mint_Loggo_LogQueue* queue) {
+    return queue->size == 0U;
+}
+
+
+// Wait for the lane to not be full
+// Add message
 // Signal that its not empty anymore
-static void Mint_Loggo_Enqueue(Mint_Loggo_LogQueue* queue, Mint_Loggo_LogMessage* message) {
+static void Mint_Loggo_Enqueue(Mint_Loggo_LogQueue* queue, Mint_Loggo_LogMessage* message, Mint_Loggo_LaneId lane_id) {
     MINT_LOGGO_MUTEX_LOCK(queue->queue_lock);
 
     #ifdef MINT__DEBUG
         assert(queue);
         assert(message);
     #endif
+
+    Mint_Loggo_LogLane* lane = &queue->lanes[lane_id];
     
     // Just dont queue if full
-    while (Mint_Loggo_IsQueueFull(queue)) {
+    while (Mint_Loggo_IsLaneFull(lane)) {
         MINT_LOGGO_COND_WAIT(queue->queue_not_full, queue->queue_lock);
     }
     
-    // Add message and advance queue
-    queue->messages[queue->head] = message;
-    queue->head = (queue->head + 1) % queue->capacity;
-    queue->size++;
+    Mint_Loggo_PushMessage(queue, lane, message);
+    MINT_LOGGO_MUTEX_UNLOCK(queue->queue_lock);
+}
 
-    // Let the thread know it has a message
-    MINT_LOGGO_COND_SIGNAL(queue->queue_not_empty);
+
+// Enqueue that refuses a closed queue, also while it waits for room, so nothing lands behind the
+// thread's last message. Closing wakes the waiters
+static bool Mint_Loggo_EnqueueIfOpen(Mint_Loggo_LogQueue* queue, Mint_Loggo_LogMessage* message, Mint_Loggo_LaneId lane_id) {
+    MINT_LOGGO_MUTEX_LOCK(queue->queue_lock);
+    Mint_Loggo_LogLane* lane = &queue->lanes[lane_id];
+    while (!queue->closed && Mint_Loggo_IsLaneFull(lane)) {
+        MINT_LOGGO_COND_WAIT(queue->queue_not_full, queue->queue_lock);
+    }
+
+    bool queued = !queue->closed;
+    if (queued) {
+        Mint_Loggo_PushMessage(queue, lane, message);
+    }
+    MINT_LOGGO_MUTEX_UNLOCK(queue->queue_lock);
+    return queued;
+}
+
+
+// Enqueue that never waits, for queues without a consumer thread and for fork, a full lane is left to the caller
+static bool Mint_Loggo_TryEnqueue(Mint_Loggo_LogQueue* queue, Mint_Loggo_LogMessage* message, Mint_Loggo_LaneId lane_id) {
+    MINT_LOGGO_MUTEX_LOCK(queue->queue_lock);
+    Mint_Loggo_LogLane* lane = &queue->lanes[lane_id];
+    bool queued = !Mint_Loggo_IsLaneFull(lane);
+    if (queued) {
+        Mint_Loggo_PushMessage(queue, lane, message);
+    }
     MINT_LOGGO_MUTEX_UNLOCK(queue->queue_lock);
+    return queued;
+}
+
+
+// Add message and advance lane, lock must be held
+static void Mint_Loggo_PushMessage(Mint_Loggo_LogQueue* queue, Mint_Loggo_LogLane* lane, Mint_Loggo_LogMessage* message) {
+    lane->messages[lane->head] = message;
+    lane->head = (lane->head + 1) % lane->capacity;
+    MINT_LOGGO_ATOMIC_STORE(&queue->size, queue->size + 1U);
+
+    // Let the thread know it has a message, a spinning thread will see the size change on its own
+    if (queue->consumer_parked) {
+        MINT_LOGGO_COND_SIGNAL(queue->queue_not_empty);
+    }
+}
+
+
+// Take the oldest urgent message, or the oldest bulk one when there are none, lock must be held
+// Producers on either lane share the condition so a lane that was full wakes all of them
+static Mint_Loggo_LogMessage* Mint_Loggo_PopMessage(Mint_Loggo_LogQueue* queue) {
+    Mint_Loggo_LogLane* lane = &queue->lanes[MINT_LOGGO_LANE_URGENT];
+    if (Mint_Loggo_IsLaneEmpty(lane)) {
+        lane = &queue->lanes[MINT_LOGGO_LANE_BULK];
+    }
+
+    bool was_full = Mint_Loggo_IsLaneFull(lane);
+    Mint_Loggo_LogMessage* message = lane->messages[lane->tail];
+    lane->messages[lane->tail] = NULL;
+    lane->tail = (lane->tail + 1) % lane->capacity;
+    MINT_LOGGO_ATOMIC_STORE(&queue->size, queue->size - 1U);
+
+    if (was_full) {
+        MINT_LOGGO_COND_BROADCAST(queue->queue_not_full);
+    }
+    return message;
 }
 
 
@@ -701,17 +2373,62 @@ static Mint_Loggo_LogMessage* Mint_Loggo_Dequeue(Mint_Loggo_LogQueue* queue) {
     #endif
 
     while (Mint_Loggo_IsQueueEmpty(queue)) {
+        // Nothing more is coming
+        if (queue->closed) {
+            MINT_LOGGO_MUTEX_UNLOCK(queue->queue_lock);
+            return &MINT_LOGGO_LOGGER_TERMINATE;
+        }
+
+        queue->consumer_parked = true;
         MINT_LOGGO_COND_WAIT(queue->queue_not_empty, queue->queue_lock);
+        queue->consumer_parked = false;
     }
 
-    Mint_Loggo_LogMessage* message = queue->messages[queue->tail];
-    queue->messages[queue->tail] = NULL;
-    queue->tail = (queue->tail + 1) % queue->capacity;
-    queue->size--;
+    Mint_Loggo_LogMessage* message = Mint_Loggo_PopMessage(queue);
+    MINT_LOGGO_MUTEX_UNLOCK(queue->queue_lock);
+    return message;
+}
+
+
+// Same as Dequeue but returns NULL instead of waiting on an empty queue
+static Mint_Loggo_LogMessage* Mint_Loggo_TryDequeue(Mint_Loggo_LogQueue* queue) {
+    MINT_LOGGO_MUTEX_LOCK(queue->queue_lock);
+
+    #ifdef MINT__DEBUG
+        assert(queue);
+    #endif
+
+    Mint_Loggo_LogMessage* message = NULL;
+    if (!Mint_Loggo_IsQueueEmpty(queue)) {
+        message = Mint_Loggo_PopMessage(queue);
+    }
 
-    MINT_LOGGO_COND_SIGNAL(queue->queue_not_full);
     MINT_LOGGO_MUTEX_UNLOCK(queue->queue_lock);
-    return message; 
+    return message;
+}
+
+
+// Spin and yield without the lock before Dequeue parks the thread
+// Returns as soon as something shows up or the budget runs out, busy poll never runs out
+static void Mint_Loggo_WaitForMessages(Mint_Loggo_LogQueue* queue, Mint_Loggo_LogFormat* format) {
+    uint32_t spins = 0U;
+    uint32_t yields = 0U;
+
+    if (format->wait_strategy == MINT_LOGGO_WAIT_BLOCK) {
+        return;
+    }
+
+    while (MINT_LOGGO_ATOMIC_LOAD(&queue->size) == 0U && !MINT_LOGGO_ATOMIC_LOAD(&queue->closed)) {
+        if (format->wait_strategy == MINT_LOGGO_WAIT_BUSY_POLL || spins < format->spin_count) {
+            spins++;
+            MINT_LOGGO_CPU_RELAX();
+        } else if (yields < format->yield_count) {
+            yields++;
+            MINT_LOGGO_THREAD_YIELD();
+        } else {
+            return;
+        }
+    }
 }
 
 
@@ -774,208 +2491,2891 @@ static char* Mint_Loggo_ColorFromLevel(Mint_Loggo_LogLevel level) {
 }
 
 
-static Mint_Loggo_LogFormat* Mint_Loggo_CreateLogFormat(Mint_Loggo_LogFormat* user_format) {
-    #ifdef MINT__DEBUG
-        assert(user_format);
-    #endif
+static Mint_Loggo_LogFormat* Mint_Loggo_CreateLogFormat(Mint_Loggo_LogFormat* user_format) {
+    #ifdef MINT__DEBUG
+        assert(user_format);
+    #endif
+
+    // Create User handler
+    Mint_Loggo_LogFormat* log_format = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_LogFormat));
+    memset(log_format, 0U, sizeof(*log_format));
+
+    // Copy user format if it exists
+    if (user_format) { 
+        memcpy(log_format, user_format, sizeof(*user_format));
+    }
+
+    // Set defaults
+    // Level defaults to LOG_DEBUG
+    // colors defaults to 0 (false)
+    // flush defaults to 0 (false)
+
+    if (!log_format->linesep) log_format->linesep = MINT_LOGGO_DEFAULT_LINE_SEP;
+    if (log_format->queue_capacity == 0) log_format->queue_capacity = MINT_LOGGO_DEFAULT_QUEUE_SIZE;
+    if (log_format->priority != MINT_LOGGO_PRIORITY_FIFO) {
+        if (log_format->urgent_level == MINT_LOGGO_LEVEL_DEBUG) log_format->urgent_level = MINT_LOGGO_LEVEL_ERROR;
+        if (log_format->urgent_capacity == 0) log_format->urgent_capacity = MINT_LOGGO_DEFAULT_URGENT_QUEUE_SIZE;
+    }
+    if (!log_format->time_format) log_format->time_format = MINT_LOGGO_DEFAULT_TIME_FORMAT;
+    if (!log_format->linebeg) log_format->linebeg = MINT_LOGGO_DEFAULT_LINE_BEG;
+    if (log_format->time_source == MINT_LOGGO_TIME_SOURCE_TSC) {
+        if (!Mint_Loggo_CalibrateCycles(NULL)) log_format->time_source = MINT_LOGGO_TIME_SOURCE_CLOCK;
+    }
+    if (log_format->wait_strategy == MINT_LOGGO_WAIT_SPIN) {
+        if (log_format->spin_count == 0) log_format->spin_count = MINT_LOGGO_DEFAULT_SPIN_COUNT;
+        if (log_format->yield_count == 0) log_format->yield_count = MINT_LOGGO_DEFAULT_YIELD_COUNT;
+    }
+    return log_format;
+}
+
+
+static Mint_Loggo_LogHandler* Mint_Loggo_CreateLogHandler(Mint_Loggo_LogHandler* user_handler) {
+
+    // Create User handler
+    Mint_Loggo_LogHandler* log_handler = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_LogHandler));
+    memset(log_handler, 0U, sizeof(*log_handler));
+
+    // Copy user format if it exists
+    if (user_handler) { 
+        memcpy(log_handler, user_handler, sizeof(*user_handler));
+
+        // You need the handle
+        if (!log_handler->handle) {
+            Mint_Loggo_DestroyLogHandler(log_handler);
+            return NULL;
+        }
+
+        // Set NULL handlers if they are not there
+        if(!log_handler->write_handler) log_handler->write_handler = Mint_Loggo_NullWrite;
+        if(!log_handler->flush_handler) log_handler->flush_handler = Mint_Loggo_NullFlush;
+        if(!log_handler->close_handler) log_handler->close_handler = Mint_Loggo_NullClose;
+
+        // Builtin writers know their length variant
+        if (!log_handler->write_len_handler) {
+            if (log_handler->write_handler == Mint_Loggo_StreamWrite) log_handler->write_len_handler = Mint_Loggo_StreamWriteLen;
+            if (log_handler->write_handler == Mint_Loggo_DescriptorWrite) log_handler->write_len_handler = Mint_Loggo_DescriptorWriteLen;
+            if (log_handler->write_handler == Mint_Loggo_NullWrite) log_handler->write_len_handler = Mint_Loggo_NullWriteLen;
+            if (log_handler->write_handler == Mint_Loggo_FileWrite) log_handler->write_len_handler = Mint_Loggo_FileWriteLen;
+            #ifdef MINT_LOGGO_HAS_SOCKETS
+                if (log_handler->write_handler == Mint_Loggo_SocketWrite) log_handler->write_len_handler = Mint_Loggo_SocketWriteLen;
+            #endif
+        }
+        if (!log_handler->write_vec_handler) {
+            if (log_handler->write_handler == Mint_Loggo_StreamWrite) log_handler->write_vec_handler = Mint_Loggo_StreamWriteVec;
+            if (log_handler->write_handler == Mint_Loggo_DescriptorWrite) log_handler->write_vec_handler = Mint_Loggo_DescriptorWriteVec;
+            if (log_handler->write_handler == Mint_Loggo_NullWrite) log_handler->write_vec_handler = Mint_Loggo_NullWriteVec;
+            if (log_handler->write_handler == Mint_Loggo_FileWrite) log_handler->write_vec_handler = Mint_Loggo_FileWriteVec;
+            #ifdef MINT_LOGGO_HAS_SOCKETS
+                if (log_handler->write_handler == Mint_Loggo_SocketWrite) log_handler->write_vec_handler = Mint_Loggo_SocketWriteVec;
+            #endif
+        }
+        if (!log_handler->record_handler && log_handler->write_handler == Mint_Loggo_FileWrite) {
+            log_handler->record_handler = Mint_Loggo_FileRecord;
+        }
+
+    } else {
+        // Defaults
+        log_handler->handle = stdout;
+        log_handler->write_handler = Mint_Loggo_StreamWrite;
+        log_handler->write_len_handler = Mint_Loggo_StreamWriteLen;
+        log_handler->write_vec_handler = Mint_Loggo_StreamWriteVec;
+        log_handler->close_handler = Mint_Loggo_StreamClose;
+        log_handler->flush_handler = Mint_Loggo_StreamFlush;
+    }
+
+    return log_handler;  
+}
+
+
+static void Mint_Loggo_DestroyLogHandler(Mint_Loggo_LogHandler* handler) {
+    #ifdef MINT__DEBUG
+        assert(handler);
+    #endif
+
+    memset(handler, 0U, sizeof(*handler));
+    MINT_LOGGO_FREE(handler);  
+}
+
+
+static void Mint_Loggo_DestroyLogFormat(Mint_Loggo_LogFormat* format) {
+    #ifdef MINT__DEBUG
+        assert(format);
+    #endif
+
+    memset(format, 0U, sizeof(*format));
+    MINT_LOGGO_FREE(format);
+}
+
+
+// Actual ouptut of message and cleanup
+static void Mint_Loggo_HandleLogMessage(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message) {
+    #ifdef MINT__DEBUG
+        assert(logger);
+        assert(message);
+    #endif
+    MINT_LOGGO_STAMP(message, MINT_LOGGO_STAMP_TAKEN);
+
+    // Callers may be writing urgent messages to the same sink
+    if (logger->format->priority == MINT_LOGGO_PRIORITY_SYNC) {
+        MINT_LOGGO_MUTEX_LOCK(logger->sink_lock);
+        Mint_Loggo_EmitMessage(logger, message);
+        MINT_LOGGO_MUTEX_UNLOCK(logger->sink_lock);
+    } else {
+        Mint_Loggo_EmitMessage(logger, message);
+    }
+
+    // Clean up message, the text lives in the same allocation
+    Mint_Loggo_FreeMessage(logger, message);
+}
+
+
+// Write one message out, uses the logger's buffers so only one thread at a time
+static void Mint_Loggo_EmitMessage(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message) {
+    Mint_Loggo_LogFormat* format = logger->format;
+    Mint_Loggo_LogHandler* handler = logger->handler;
+
+    // Levels were filtered when the message was logged
+    if (message->adopted) {
+        message->msg_len = strlen(message->msg);
+    }
+
+    if (handler->record_handler) {
+        handler->record_handler(message->level, Mint_Loggo_StampToNs(logger, message->timestamp), handler->handle);
+    }
+
+    if ((message->adopted || message->borrowed) && handler->write_vec_handler && format->output == MINT_LOGGO_OUTPUT_TEXT && format->sanitize == MINT_LOGGO_SANITIZE_NONE) {
+        // Adopted and borrowed text is written from where it is, only the prefix is laid out
+        Mint_Loggo_LinePieces* pieces = Mint_Loggo_PiecesFor(logger, message);
+        size_t head = Mint_Loggo_AssembleHead(logger, message, 0U);
+        Mint_Loggo_IoVec parts[3] = {{logger->scratch, head}, {message->msg, message->msg_len}, {pieces->suffix, pieces->suffix_len}};
+        MINT_LOGGO_STAMP(message, MINT_LOGGO_STAMP_FORMATTED);
+        handler->write_vec_handler(parts, 3, handler->handle);
+    } else {
+        // One contiguous write per line
+        size_t len = format->output == MINT_LOGGO_OUTPUT_TRACE ? Mint_Loggo_AssembleTrace(logger, message) : Mint_Loggo_AssembleLine(logger, message);
+        MINT_LOGGO_STAMP(message, MINT_LOGGO_STAMP_FORMATTED);
+        Mint_Loggo_WriteOut(logger, logger->scratch, len);
+    }
+
+    // Flush if needed
+    if (MINT_LOGGO_ATOMIC_LOAD(&format->flush)) {
+        handler->flush_handler(handler->handle);
+    }
+    MINT_LOGGO_RECORD_LATENCY(logger, message);
+}
+
+
+// Pick a lane, or skip the queue entirely for urgent messages in sync mode
+static void Mint_Loggo_Submit(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message) {
+    // Children go through the queue of the logger that owns the thread
+    if (logger->owner) {
+        message->source = logger;
+        logger = logger->owner;
+    }
+
+    Mint_Loggo_LogFormat* format = logger->format;
+    bool urgent = format->priority != MINT_LOGGO_PRIORITY_FIFO && message->kind == MINT_LOGGO_MESSAGE_LOG && message->level >= format->urgent_level;
+    MINT_LOGGO_STAMP(message, MINT_LOGGO_STAMP_SUBMITTED);
+
+    if (urgent && format->priority == MINT_LOGGO_PRIORITY_SYNC) {
+        Mint_Loggo_WriteUrgent(logger, message);
+        return;
+    }
+
+    Mint_Loggo_LaneId lane_id = urgent ? MINT_LOGGO_LANE_URGENT : MINT_LOGGO_LANE_BULK;
+    if (!format->threadless) {
+        Mint_Loggo_Enqueue(logger->queue, message, lane_id);
+        return;
+    }
+
+    // Nobody else drains a threadless logger, a full lane is written out here instead of waited on
+    while (!Mint_Loggo_TryEnqueue(logger->queue, message, lane_id)) {
+        Mint_Loggo_DrainLogger(logger, 0U);
+    }
+    Mint_Loggo_SignalPending();
+}
+
+
+// Sync mode callers and threadless drains share the sink with whoever else writes it
+static bool Mint_Loggo_LocksSink(Mint_Loggo_Logger* logger) {
+    return logger->format->priority == MINT_LOGGO_PRIORITY_SYNC || logger->format->threadless;
+}
+
+
+// Written and flushed before the call returns, whatever is still queued comes out after it
+static void Mint_Loggo_WriteUrgent(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message) {
+    MINT_LOGGO_STAMP(message, MINT_LOGGO_STAMP_TAKEN);
+    MINT_LOGGO_MUTEX_LOCK(logger->sink_lock);
+    Mint_Loggo_EmitMessage(logger, message);
+    if (!MINT_LOGGO_ATOMIC_LOAD(&logger->format->flush)) {
+        logger->handler->flush_handler(logger->handler->handle);
+    }
+    MINT_LOGGO_MUTEX_UNLOCK(logger->sink_lock);
+
+    Mint_Loggo_ReleaseMessage(logger, message);
+}
+
+
+// Queue the change behind everything already logged and wait for the logger thread to make it
+// An idle logger has no thread so the change is made here while it is held in the starting state
+// With no changes it waits for the logger thread to get past everything queued so far
+// The caller holds the logger. Returns false when the queue closed first, nothing is changed then
+static bool Mint_Loggo_QueueReconfigure(Mint_Loggo_Logger* logger, Mint_Loggo_LogHandler* handler, int32_t colors) {
+    Mint_Loggo_Reconfigure reconfigure = {.handler = handler, .colors = colors, .done = false, .dropped = false};
+    if (MINT_LOGGO_ATOMIC_CAS(&logger->state, MINT_LOGGO_LOGGER_IDLE, MINT_LOGGO_LOGGER_STARTING)) {
+        Mint_Loggo_ApplyReconfigure(logger, &reconfigure);
+        MINT_LOGGO_ATOMIC_STORE(&logger->state, MINT_LOGGO_LOGGER_IDLE);
+        return true;
+    }
+    Mint_Loggo_WakeLogger(logger);
+
+    // Nobody to wait for without a thread, what is queued goes to the old sink right here
+    if (logger->format->threadless) {
+        Mint_Loggo_DrainLogger(logger, 0U);
+        Mint_Loggo_ApplyReconfigure(logger, &reconfigure);
+        return true;
+    }
+
+    // A closed queue may have no thread left behind it to make the change
+    Mint_Loggo_LogMessage* message = Mint_Loggo_AllocMessage(logger, sizeof(Mint_Loggo_LogMessage));
+    memset(message, 0U, sizeof(*message));
+    message->kind = MINT_LOGGO_MESSAGE_RECONFIGURE;
+    message->payload = &reconfigure;
+    if (!Mint_Loggo_EnqueueIfOpen(logger->queue, message, MINT_LOGGO_LANE_BULK)) {
+        Mint_Loggo_ReleaseMessage(logger, message);
+        return false;
+    }
+
+    // Whatever is accepted is either made by the thread or dropped with the queue, both end in MarkDone
+    MINT_LOGGO_MUTEX_LOCK(MINT_LOGGO_WAIT_LOCK);
+    while (!reconfigure.done) {
+        MINT_LOGGO_COND_WAIT(MINT_LOGGO_WAIT_SIGNAL, MINT_LOGGO_WAIT_LOCK);
+    }
+    MINT_LOGGO_MUTEX_UNLOCK(MINT_LOGGO_WAIT_LOCK);
+    return !reconfigure.dropped;
+}
+
+
+// Wakes the caller of QueueReconfigure, which may return (and take reconfigure with it) as soon as the lock is let go
+static void Mint_Loggo_MarkDone(Mint_Loggo_Reconfigure* reconfigure, bool dropped) {
+    MINT_LOGGO_MUTEX_LOCK(MINT_LOGGO_WAIT_LOCK);
+    reconfigure->dropped = dropped;
+    reconfigure->done = true;
+    MINT_LOGGO_COND_BROADCAST(MINT_LOGGO_WAIT_SIGNAL);
+    MINT_LOGGO_MUTEX_UNLOCK(MINT_LOGGO_WAIT_LOCK);
+}
+
+
+// Runs on the logger thread between two messages, other writers of the sink are kept out meanwhile
+static void Mint_Loggo_ApplyReconfigure(Mint_Loggo_Logger* logger, Mint_Loggo_Reconfigure* reconfigure) {
+    bool running = MINT_LOGGO_ATOMIC_LOAD(&logger->state) == MINT_LOGGO_LOGGER_RUNNING;
+    bool sync = Mint_Loggo_LocksSink(logger) && running;
+    if (sync) {
+        MINT_LOGGO_MUTEX_LOCK(logger->sink_lock);
+    }
+
+    if (reconfigure->handler) {
+        Mint_Loggo_LogHandler* handler = logger->handler;
+
+        // The old sink gets a complete trace array, the new one starts its own
+        if (logger->format->output == MINT_LOGGO_OUTPUT_TRACE && logger->trace_events) {
+            Mint_Loggo_WriteOut(logger, "\n]\n", 3U);
+            logger->trace_events = 0U;
+        }
+        if (running) {
+            handler->flush_handler(handler->handle);
+        }
+
+        logger->handler = reconfigure->handler;
+        Mint_Loggo_DestroyLogHandler(handler);
+    }
+
+    // Pieces only exist once the logger started, an idle one builds them with the new setting
+    if (reconfigure->colors >= 0 && logger->format->colors != (reconfigure->colors != 0)) {
+        logger->format->colors = reconfigure->colors != 0;
+        if (running) {
+            Mint_Loggo_DestroyLinePieces(logger);
+            Mint_Loggo_BuildLinePieces(logger);
+            logger->pieces_generation++;
+        }
+    }
+
+    if (sync) {
+        MINT_LOGGO_MUTEX_UNLOCK(logger->sink_lock);
+    }
+}
+
+
+// Hand text to the sink, the length is only used when the sink takes it
+static void Mint_Loggo_WriteOut(Mint_Loggo_Logger* logger, const char* text, size_t len) {
+    Mint_Loggo_LogHandler* handler = logger->handler;
+    if (handler->write_len_handler) {
+        handler->write_len_handler(text, len, handler->handle);
+    } else {
+        handler->write_handler((char*)text, handler->handle);
+    }
+}
+
+
+// Flush from the logger thread, sync mode callers may be mid write
+static void Mint_Loggo_FlushSink(Mint_Loggo_Logger* logger) {
+    Mint_Loggo_LogHandler* handler = logger->handler;
+    if (Mint_Loggo_LocksSink(logger)) {
+        MINT_LOGGO_MUTEX_LOCK(logger->sink_lock);
+        handler->flush_handler(handler->handle);
+        MINT_LOGGO_MUTEX_UNLOCK(logger->sink_lock);
+    } else {
+        handler->flush_handler(handler->handle);
+    }
+}
+
+
+// Grow one of the per logger buffers, only the logger thread touches them
+static void Mint_Loggo_ReserveBuffer(char** buffer, size_t* capacity, size_t size) {
+    if (size > *capacity) {
+        *capacity = size > *capacity * 2U ? size : *capacity * 2U;
+        *buffer = MINT_LOGGO_REALLOC(*buffer, *capacity);
+    }
+}
+
+
+// Thread safe strftime of a timestamp, returns the length written
+static size_t Mint_Loggo_FormatTime(char* buffer, size_t size, const char* time_format, time_t timestamp) {
+    struct tm local_time;
+    #if defined(_WIN32)
+        localtime_s(&local_time, &timestamp);
+    #else
+        localtime_r(&timestamp, &local_time);
+    #endif
+    size_t len = strftime(buffer, size, time_format, &local_time);
+    buffer[len] = '\0';
+    return len;
+}
+
+
+// ".123", ".123456" or ".123456789" depending on precision, returns the length written
+static size_t Mint_Loggo_FormatFraction(char* buffer, uint64_t nanos, Mint_Loggo_TimePrecision precision) {
+    uint32_t digits = 0U;
+    switch (precision) {
+        case MINT_LOGGO_PRECISION_MILLIS:
+            digits = 3U;
+            break;
+        case MINT_LOGGO_PRECISION_MICROS:
+            digits = 6U;
+            break;
+        case MINT_LOGGO_PRECISION_NANOS:
+            digits = 9U;
+            break;
+        default:
+            return 0U;
+    }
+
+    // Fill from the right dropping the digits past the precision
+    for (uint32_t drop = 9U; drop > digits; drop--) {
+        nanos /= 10U;
+    }
+    buffer[0] = '.';
+    for (uint32_t idx = digits; idx > 0U; idx--) {
+        buffer[idx] = (char)('0' + (nanos % 10U));
+        nanos /= 10U;
+    }
+    return digits + 1U;
+}
+
+
+// Join three strings into a new piece, returns its length
+static size_t Mint_Loggo_MakePiece(char** piece, const char* first, const char* second, const char* third) {
+    size_t len = strlen(first) + strlen(second) + strlen(third);
+    *piece = MINT_LOGGO_MALLOC(len + 1U);
+    sprintf(*piece, "%s%s%s", first, second, third);
+    return len;
+}
+
+
+// Done once per logger so nothing about the line layout is looked up per message
+static void Mint_Loggo_BuildLinePieces(Mint_Loggo_Logger* logger) {
+    Mint_Loggo_LogFormat* format = logger->format;
+    for (int32_t slot = 0; slot < MINT_LOGGO_LEVEL_SLOTS; slot++) {
+        Mint_Loggo_LinePieces* pieces = &logger->pieces[slot];
+
+        // {"time":"<time>","level":"INFO","logger":"name","msg":"<text>"}
+        if (format->output == MINT_LOGGO_OUTPUT_JSON) {
+            size_t name_len = strlen(logger->name);
+            char* name = MINT_LOGGO_MALLOC(name_len * 6U + 1U);
+            name[Mint_Loggo_SanitizeCopy(name, logger->name, name_len, MINT_LOGGO_SANITIZE_ESCAPE, true)] = '\0';
+
+            pieces->prefix_len = Mint_Loggo_MakePiece(&pieces->prefix, "{\"time\":\"", "", "");
+            pieces->tag = MINT_LOGGO_MALLOC(strlen(name) + 64U);
+            pieces->tag_len = (size_t)sprintf(pieces->tag, "\",\"level\":\"%s\",\"logger\":\"%s\",\"msg\":\"", Mint_Loggo_StringFromLevel((Mint_Loggo_LogLevel)slot), name);
+            pieces->suffix_len = Mint_Loggo_MakePiece(&pieces->suffix, "\"}", format->linesep, "");
+            MINT_LOGGO_FREE(name);
+            continue;
+        }
+
+        const char* color = format->colors ? Mint_Loggo_ColorFromLevel((Mint_Loggo_LogLevel)slot) : "";
+        const char* reset = format->colors ? MINT_LOGGO_RESET : "";
+        pieces->prefix_len = Mint_Loggo_MakePiece(&pieces->prefix, color, format->linebeg, " [");
+        pieces->tag_len = Mint_Loggo_MakePiece(&pieces->tag, "] ", Mint_Loggo_StringFromLevel((Mint_Loggo_LogLevel)slot), " ");
+        pieces->suffix_len = Mint_Loggo_MakePiece(&pieces->suffix, format->linesep, reset, "");
+    }
+}
+
+
+static void Mint_Loggo_DestroyLinePieces(Mint_Loggo_Logger* logger) {
+    for (int32_t slot = 0; slot < MINT_LOGGO_LEVEL_SLOTS; slot++) {
+        Mint_Loggo_LinePieces* pieces = &logger->pieces[slot];
+        MINT_LOGGO_FREE(pieces->prefix);
+        MINT_LOGGO_FREE(pieces->tag);
+        MINT_LOGGO_FREE(pieces->suffix);
+        memset(pieces, 0U, sizeof(*pieces));
+    }
+}
+
+
+// Line pieces for a level, out of range levels share the unknown slot
+// A child's pieces carry its own name, they are built by whoever writes for the owner when first needed
+static Mint_Loggo_LinePieces* Mint_Loggo_PiecesFor(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message) {
+    Mint_Loggo_Logger* source = message->source;
+    if (source) {
+        if (source->pieces_generation != logger->pieces_generation) {
+            if (source->pieces_generation) {
+                Mint_Loggo_DestroyLinePieces(source);
+            }
+            Mint_Loggo_BuildLinePieces(source);
+            source->pieces_generation = logger->pieces_generation;
+        }
+        logger = source;
+    }
+
+    Mint_Loggo_LogLevel level = message->level;
+    int32_t slot = (level >= MINT_LOGGO_LEVEL_DEBUG && level <= MINT_LOGGO_LEVEL_FATAL) ? (int32_t)level : MINT_LOGGO_LEVEL_SLOTS - 1;
+    return &logger->pieces[slot];
+}
+
+
+// Lay out "<prefix>time<tag>" at the start of scratch with room for extra bytes behind it, returns its length
+static size_t Mint_Loggo_AssembleHead(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message, size_t extra) {
+    Mint_Loggo_LinePieces* pieces = Mint_Loggo_PiecesFor(logger, message);
+
+    uint64_t nanos = Mint_Loggo_StampToNs(logger, message->timestamp);
+    time_t seconds = (time_t)(nanos / 1000000000U);
+    if (!logger->time_cache_valid || logger->time_cache_stamp != seconds) {
+        // strftime can put quotes, backslashes or tabs in the time, JSON escapes it like any other string
+        if (logger->format->output == MINT_LOGGO_OUTPUT_JSON) {
+            char formatted[128U];
+            size_t formatted_len = Mint_Loggo_FormatTime(formatted, sizeof(formatted), logger->format->time_format, seconds);
+            logger->time_cache_len = Mint_Loggo_SanitizeCopy(logger->time_cache, formatted, formatted_len, MINT_LOGGO_SANITIZE_ESCAPE, true);
+        } else {
+            logger->time_cache_len = Mint_Loggo_FormatTime(logger->time_cache, sizeof(logger->time_cache) / 6U, logger->format->time_format, seconds);
+        }
+        logger->time_cache_stamp = seconds;
+        logger->time_cache_valid = true;
+    }
+
+    char fraction[16U];
+    size_t fraction_len = Mint_Loggo_FormatFraction(fraction, nanos % 1000000000U, logger->format->time_precision);
+    size_t time_len = logger->time_cache_len + fraction_len;
+
+    // Text lines show the thread and its context between the level and the message, JSON puts them after msg
+    // Context goes in the way the message text does, as set or run through the format's sanitize mode
+    char thread[32U];
+    size_t thread_len = 0U;
+    const char* context = NULL;
+    size_t context_len = 0U;
+    if (logger->format->output != MINT_LOGGO_OUTPUT_JSON) {
+        if (logger->format->thread_id) {
+            thread_len = (size_t)sprintf(thread, "tid=%llu ", (unsigned long long)message->thread_id);
+        }
+        if (message->context && logger->format->sanitize == MINT_LOGGO_SANITIZE_NONE) {
+            context = message->context->text;
+            context_len = message->context->text_len;
+        } else if (message->context && logger->format->sanitize == MINT_LOGGO_SANITIZE_STRIP) {
+            context = message->context->stripped;
+            context_len = message->context->stripped_len;
+        } else if (message->context) {
+            context = message->context->escaped;
+            context_len = message->context->escaped_len;
+        }
+    }
+
+    size_t tag_end = pieces->prefix_len + time_len + pieces->tag_len;
+    size_t head = tag_end + thread_len + context_len;
+    Mint_Loggo_ReserveBuffer(&logger->scratch, &logger->scratch_capacity, head + extra);
+
+    char* line = logger->scratch;
+    memcpy(line, pieces->prefix, pieces->prefix_len);
+    memcpy(line + pieces->prefix_len, logger->time_cache, logger->time_cache_len);
+    memcpy(line + pieces->prefix_len + logger->time_cache_len, fraction, fraction_len);
+    memcpy(line + pieces->prefix_len + time_len, pieces->tag, pieces->tag_len);
+    memcpy(line + tag_end, thread, thread_len);
+    if (context_len) {
+        memcpy(line + tag_end + thread_len, context, context_len);
+    }
+    return head;
+}
+
+
+// Lay out "<prefix>time<tag>text<suffix>" in the scratch buffer, returns the line length
+// Time is only reformatted when the second changes, deferred payloads are formatted in place
+static size_t Mint_Loggo_AssembleLine(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message) {
+    Mint_Loggo_LinePieces* pieces = Mint_Loggo_PiecesFor(logger, message);
+    bool sanitize = logger->format->output == MINT_LOGGO_OUTPUT_JSON || logger->format->sanitize != MINT_LOGGO_SANITIZE_NONE;
+    const char* text = message->msg;
+    size_t body = message->msg_len;
+
+    // Trace events read as lines, the span name is borrowed so it goes through the render buffer
+    if (message->kind != MINT_LOGGO_MESSAGE_LOG) {
+        const char* what = message->kind == MINT_LOGGO_MESSAGE_TRACE_BEGIN ? "begin " : message->kind == MINT_LOGGO_MESSAGE_TRACE_END ? "end " : "event ";
+        Mint_Loggo_ReserveBuffer(&logger->render, &logger->render_capacity, strlen(text) + 8U);
+        body = (size_t)sprintf(logger->render, "%s%s", what, text);
+        text = logger->render;
+    }
+
+    // Sanitized payloads are rendered on the side first, they are copied (and escaped) below
+    if (message->formatter && sanitize && message->kind == MINT_LOGGO_MESSAGE_LOG) {
+        body = message->formatter(message->payload, logger->render, logger->render_capacity);
+        if (body >= logger->render_capacity) {
+            Mint_Loggo_ReserveBuffer(&logger->render, &logger->render_capacity, body + 1U);
+            message->formatter(message->payload, logger->render, logger->render_capacity);
+        }
+        text = logger->render;
+    } else if (message->formatter) {
+        body = MINT_LOGGO_DEFAULT_SCRATCH_SIZE;
+    }
+
+    // JSON closes msg then adds the thread and context fields, the suffix then starts past its own quote
+    char fields[32U];
+    size_t fields_len = 0U;
+    size_t context_len = 0U;
+    if (logger->format->output == MINT_LOGGO_OUTPUT_JSON && (logger->format->thread_id || message->context)) {
+        fields_len = logger->format->thread_id ? (size_t)sprintf(fields, "\",\"tid\":%llu", (unsigned long long)message->thread_id) : (size_t)sprintf(fields, "\"");
+        context_len = message->context ? message->context->json_len : 0U;
+    }
+    size_t tail = fields_len + context_len + pieces->suffix_len - (fields_len ? 1U : 0U);
+
+    // Escaping grows a byte to at most \u00XX
+    size_t reserve = sanitize ? body * 6U : body;
+    size_t head = Mint_Loggo_AssembleHead(logger, message, reserve + tail + 1U);
+
+    if (sanitize) {
+        body = Mint_Loggo_SanitizeCopy(logger->scratch + head, text, body, logger->format->sanitize, logger->format->output == MINT_LOGGO_OUTPUT_JSON);
+    } else if (message->formatter) {
+        // Formatters report what they need so one retry is enough, like snprintf they keep a byte for the NUL
+        size_t room = logger->scratch_capacity - head - tail - 1U;
+        body = message->formatter(message->payload, logger->scratch + head, room);
+        if (body >= room) {
+            Mint_Loggo_ReserveBuffer(&logger->scratch, &logger->scratch_capacity, head + body + tail + 1U);
+            message->formatter(message->payload, logger->scratch + head, body + 1U);
+        }
+    } else {
+        memcpy(logger->scratch + head, text, body);
+    }
+
+    char* end = logger->scratch + head + body;
+    if (fields_len) {
+        memcpy(end, fields, fields_len);
+        end += fields_len;
+        if (context_len) {
+            memcpy(end, message->context->json, context_len);
+            end += context_len;
+        }
+        memcpy(end, pieces->suffix + 1U, pieces->suffix_len - 1U);
+        end += pieces->suffix_len - 1U;
+    } else {
+        memcpy(end, pieces->suffix, pieces->suffix_len);
+        end += pieces->suffix_len;
+    }
+    *end = '\0';
+    return (size_t)(end - logger->scratch);
+}
+
+
+// Bytes that sanitizing has to look at, everything else is copied as is
+#define MINT_LOGGO_NEEDS_SANITIZE(c) ((unsigned char)(c) < 0x20U || (c) == '"' || (c) == '\\' || (unsigned char)(c) == 0x7FU)
+
+
+// Length of the leading run of bytes that need no sanitizing
+// Vectorized when the compiler targets SSE2/AVX2 (unless MINT_LOGGO_NO_SIMD), the scalar tail finishes the job either way
+static size_t Mint_Loggo_ScanClean(const char* text, size_t len) {
+    size_t idx = 0U;
+
+    #if defined(__AVX2__) && !defined(MINT_LOGGO_NO_SIMD)
+        const __m256i control = _mm256_set1_epi8(0x1F);
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i del = _mm256_set1_epi8(0x7F);
+        for (; idx + 32U <= len; idx += 32U) {
+            __m256i chunk = _mm256_loadu_si256((const __m256i*)(text + idx));
+            __m256i hits = _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control), control);
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, quote));
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, backslash));
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, del));
+            uint32_t mask = (uint32_t)_mm256_movemask_epi8(hits);
+            if (mask) {
+                return idx + (size_t)__builtin_ctz(mask);
+            }
+        }
+    #endif
+
+    #if (defined(__SSE2__) || defined(_M_X64)) && !defined(MINT_LOGGO_NO_SIMD)
+        const __m128i control16 = _mm_set1_epi8(0x1F);
+        const __m128i quote16 = _mm_set1_epi8('"');
+        const __m128i backslash16 = _mm_set1_epi8('\\');
+        const __m128i del16 = _mm_set1_epi8(0x7F);
+        for (; idx + 16U <= len; idx += 16U) {
+            __m128i chunk = _mm_loadu_si128((const __m128i*)(text + idx));
+            // max(c, 0x1F) == 0x1F only for c <= 0x1F unsigned
+            __m128i hits = _mm_cmpeq_epi8(_mm_max_epu8(chunk, control16), control16);
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, quote16));
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, backslash16));
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, del16));
+            uint32_t mask = (uint32_t)_mm_movemask_epi8(hits);
+            if (mask) {
+                #if defined(_MSC_VER) && !defined(__clang__)
+                    unsigned long first;
+                    _BitScanForward(&first, mask);
+                    return idx + (size_t)first;
+                #else
+                    return idx + (size_t)__builtin_ctz(mask);
+                #endif
+            }
+        }
+    #endif
+
+    for (; idx < len; idx++) {
+        if (MINT_LOGGO_NEEDS_SANITIZE(text[idx])) {
+            break;
+        }
+    }
+    return idx;
+}
+
+
+// Copy text into out escaping or stripping as asked, JSON always escapes quotes and backslashes
+// out needs room for len * 6 bytes, returns the bytes written
+static size_t Mint_Loggo_SanitizeCopy(char* out, const char* text, size_t len, Mint_Loggo_Sanitize mode, bool json) {
+    static const char hex[] = "0123456789abcdef";
+    size_t written = 0U;
+    size_t idx = 0U;
+
+    while (idx < len) {
+        // Clean runs are one memcpy, for clean messages that is the whole thing
+        size_t clean = Mint_Loggo_ScanClean(text + idx, len - idx);
+        memcpy(out + written, text + idx, clean);
+        written += clean;
+        idx += clean;
+        if (idx == len) {
+            break;
+        }
+
+        unsigned char current = (unsigned char)text[idx++];
+        bool control = current < 0x20U || current == 0x7FU;
+
+        if (!control) {
+            // Quote or backslash, only escaped when the output needs it
+            if (json || mode == MINT_LOGGO_SANITIZE_ESCAPE) {
+                out[written++] = '\\';
+            }
+            out[written++] = (char)current;
+        } else if (mode == MINT_LOGGO_SANITIZE_STRIP) {
+            continue;
+        } else if (current == '\n') {
+            out[written++] = '\\';
+            out[written++] = 'n';
+        } else if (current == '\r') {
+            out[written++] = '\\';
+            out[written++] = 'r';
+        } else if (current == '\t') {
+            out[written++] = '\\';
+            out[written++] = 't';
+        } else if (json) {
+            memcpy(out + written, "\\u00", 4U);
+            out[written + 4U] = hex[current >> 4U];
+            out[written + 5U] = hex[current & 0xFU];
+            written += 6U;
+        } else {
+            out[written++] = '\\';
+            out[written++] = 'x';
+            out[written++] = hex[current >> 4U];
+            out[written++] = hex[current & 0xFU];
+        }
+    }
+
+    return written;
+}
+
+
+// One Chrome trace event, the array is opened by the first event and closed when the logger stops
+// {"name":"span","cat":"logger","ph":"B","ts":123.456,"pid":1,"tid":2}
+static size_t Mint_Loggo_AssembleTrace(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message) {
+    uint64_t nanos = Mint_Loggo_StampToNs(logger, message->timestamp);
+    bool log = message->kind == MINT_LOGGO_MESSAGE_LOG;
+    const char* name = log ? Mint_Loggo_StringFromLevel(message->level) : message->msg;
+    size_t name_len = strlen(name);
+    const char* logger_name = message->source ? message->source->name : logger->name;
+    size_t logger_len = strlen(logger_name);
+    char phase = message->kind == MINT_LOGGO_MESSAGE_TRACE_BEGIN ? 'B' : message->kind == MINT_LOGGO_MESSAGE_TRACE_END ? 'E' : 'i';
+
+    // Log text is rendered on the side when it was deferred
+    const char* text = message->msg;
+    size_t text_len = message->msg_len;
+    if (log && message->formatter) {
+        text_len = message->formatter(message->payload, logger->render, logger->render_capacity);
+        if (text_len >= logger->render_capacity) {
+            Mint_Loggo_ReserveBuffer(&logger->render, &logger->render_capacity, text_len + 1U);
+            message->formatter(message->payload, logger->render, logger->render_capacity);
+        }
+        text = logger->render;
+    }
+
+    Mint_Loggo_ReserveBuffer(&logger->scratch, &logger->scratch_capacity, 256U + (name_len + logger_len + (log ? text_len : 0U)) * 6U);
+    char* line = logger->scratch;
+    size_t len = 0U;
+
+    len += (size_t)sprintf(line, "%s{\"name\":\"", logger->trace_events++ ? ",\n" : "[\n");
+    len += Mint_Loggo_SanitizeCopy(line + len, name, name_len, MINT_LOGGO_SANITIZE_ESCAPE, true);
+    len += (size_t)sprintf(line + len, "\",\"cat\":\"");
+    len += Mint_Loggo_SanitizeCopy(line + len, logger_name, logger_len, MINT_LOGGO_SANITIZE_ESCAPE, true);
+    len += (size_t)sprintf(line + len, "\",\"ph\":\"%c\",\"ts\":%llu.%03u,\"pid\":%llu,\"tid\":%llu",
+                           phase, (unsigned long long)(nanos / 1000U), (unsigned int)(nanos % 1000U),
+                           (unsigned long long)logger->pid, (unsigned long long)message->thread_id);
+
+    // Instants are thread scoped, log lines keep their text as an argument
+    if (phase == 'i') {
+        len += (size_t)sprintf(line + len, ",\"s\":\"t\"");
+    }
+    if (log) {
+        len += (size_t)sprintf(line + len, ",\"args\":{\"msg\":\"");
+        len += Mint_Loggo_SanitizeCopy(line + len, text, text_len, MINT_LOGGO_SANITIZE_ESCAPE, true);
+        len += (size_t)sprintf(line + len, "\"}");
+    }
+
+    line[len++] = '}';
+    line[len] = '\0';
+    return len;
+}
+
+
+// Everything a logger needs before it is started and published, NULL without a usable handler
+static Mint_Loggo_Logger* Mint_Loggo_MakeLogger(const char* name, Mint_Loggo_LogFormat* user_format, Mint_Loggo_LogHandler* user_handler) {
+    Mint_Loggo_Logger* logger = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_Logger));
+    memset(logger, 0U, sizeof(*logger));
+
+    // Fill up with info
+    logger->handler = Mint_Loggo_CreateLogHandler(user_handler);
+
+    // Clean up and return NULL
+    if (!logger->handler) {
+        memset(logger, 0U, sizeof(*logger));
+        MINT_LOGGO_FREE(logger);
+        return NULL;
+    }
+
+    logger->format = Mint_Loggo_CreateLogFormat(user_format);
+    logger->name = name;
+    if (logger->format->time_source == MINT_LOGGO_TIME_SOURCE_TSC) {
+        Mint_Loggo_CalibrateCycles(&logger->clock);
+    }
+    logger->pid = MINT_LOGGO_GET_PID();
+    logger->allocator = logger->format->allocator ? *logger->format->allocator : MINT_LOGGO_ALLOCATOR;
+    logger->own_level = (int32_t)logger->format->level;
+    logger->level = logger->format->level;
+    #ifdef MINT_LOGGO_LATENCY_STATS
+        logger->latency = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_LatencyStats));
+        memset(logger->latency, 0U, sizeof(*logger->latency));
+    #endif
+
+    // Made here so a lazy start on another thread never races the application for it
+    if (logger->format->threadless) {
+        Mint_Loggo_EventFd();
+    }
+    return logger;
+}
+
+
+// Build what only a running logger needs then spin up its thread
+static void Mint_Loggo_StartLogger(Mint_Loggo_Logger* logger) {
+    Mint_Loggo_BuildLinePieces(logger);
+    logger->pieces_generation++;
+    if (logger->format->pool_slots) {
+        logger->pool = Mint_Loggo_CreatePool(&logger->allocator, logger->format->pool_slots, logger->format->pool_slot_size);
+    }
+    if (Mint_Loggo_LocksSink(logger)) {
+        MINT_LOGGO_MUTEX_INIT(logger->sink_lock);
+    }
+
+    // Sync mode never queues urgent messages so it doesnt need the lane
+    uint32_t urgent_capacity = logger->format->priority == MINT_LOGGO_PRIORITY_LANES ? logger->format->urgent_capacity : 0U;
+    logger->queue = Mint_Loggo_CreateQueue(logger->format->queue_capacity, urgent_capacity);
+    if (!logger->format->threadless) {
+        MINT_LOGGO_THREAD_CREATE(&logger->thread_id, Mint_Loggo_RunLogger, ((void*)logger));
+    }
+    MINT_LOGGO_ATOMIC_STORE(&logger->state, MINT_LOGGO_LOGGER_RUNNING);
+}
+
+
+// Start a lazy logger the first time it has something to write, one caller wins the race and the rest wait
+// Callers filter the level first. A child wakes the logger it writes through
+// A reconfigured idle logger goes back to idle instead of running so waiters look again
+static void Mint_Loggo_WakeLogger(Mint_Loggo_Logger* logger) {
+    logger = Mint_Loggo_OwnerOf(logger);
+    for (;;) {
+        uint32_t state = MINT_LOGGO_ATOMIC_LOAD(&logger->state);
+        if (state == MINT_LOGGO_LOGGER_RUNNING) {
+            return;
+        }
+
+        if (state == MINT_LOGGO_LOGGER_IDLE && MINT_LOGGO_ATOMIC_CAS(&logger->state, MINT_LOGGO_LOGGER_IDLE, MINT_LOGGO_LOGGER_STARTING)) {
+            Mint_Loggo_StartLogger(logger);
+            return;
+        }
+
+        MINT_LOGGO_THREAD_YIELD();
+    }
+}
+
+
+static Mint_Loggo_Logger* Mint_Loggo_OwnerOf(Mint_Loggo_Logger* logger) {
+    return logger->owner ? logger->owner : logger;
+}
+
+
+// Hierarchy
+
+
+// Nearest logger named by a dotted prefix of name, "a.b.c" tries "a.b" and then "a"
+static Mint_Loggo_Logger* Mint_Loggo_FindAncestor(const char* name) {
+    size_t len = strlen(name);
+    char* prefix = MINT_LOGGO_MALLOC(len + 1U);
+    memcpy(prefix, name, len + 1U);
+
+    Mint_Loggo_Logger* ancestor = NULL;
+    char* dot = NULL;
+    while (!ancestor && (dot = strrchr(prefix, '.'))) {
+        *dot = '\0';
+        ancestor = Mint_Loggo_HTFindItem(prefix);
+    }
+
+    MINT_LOGGO_FREE(prefix);
+    return ancestor;
+}
+
+
+// Work out every effective level again, called whenever a logger comes, goes or gets a level
+// Rare enough that walking the whole table is fine, producers only ever see the stored result
+static void Mint_Loggo_ResolveLevels() {
+    Mint_Loggo_HashTable* table = &MINT_LOGGO_LOGGER_HASH_TABLE;
+    for (int32_t idx = 0; idx < table->capacity; idx++) {
+        Mint_Loggo_Logger* logger = table->loggers[idx];
+        if (logger && logger != &MINT_LOGGO_LOGGER_DELETED) {
+            logger->level_resolved = false;
+        }
+    }
+
+    for (int32_t idx = 0; idx < table->capacity; idx++) {
+        Mint_Loggo_Logger* logger = table->loggers[idx];
+        if (logger && logger != &MINT_LOGGO_LOGGER_DELETED) {
+            Mint_Loggo_ResolveLevel(logger);
+        }
+    }
+}
+
+
+// Own level, else the nearest ancestor's, else what the format was created with
+static Mint_Loggo_LogLevel Mint_Loggo_ResolveLevel(Mint_Loggo_Logger* logger) {
+    if (!logger->level_resolved) {
+        Mint_Loggo_LogLevel level = logger->format->level;
+        if (logger->own_level >= 0) {
+            level = (Mint_Loggo_LogLevel)logger->own_level;
+        } else {
+            Mint_Loggo_Logger* parent = Mint_Loggo_FindAncestor(logger->name);
+            if (parent) {
+                level = Mint_Loggo_ResolveLevel(parent);
+            }
+        }
+
+        logger->level_resolved = true;
+        MINT_LOGGO_ATOMIC_STORE(&logger->level, level);
+    }
+    return logger->level;
+}
+
+
+// Thread spawned handler of messages
+static void* Mint_Loggo_RunLogger(void* arg) {
+    #ifdef MINT__DEBUG
+        assert(arg);
+    #endif
+    Mint_Loggo_Logger* logger = arg;
+    #ifdef MINT__DEBUG
+        assert(logger->queue);
+    #endif
+
+    Mint_Loggo_ConfigureThread(logger->format);
+
+    // For some reason you have to grab the read lock and read all that you can in a loop
+    // Or else the condition is never signaled and you wait
+    while (!logger->done && !MINT_LOGGO_ATOMIC_LOAD(&logger->abandon)) {
+        Mint_Loggo_LogMessage* message = Mint_Loggo_TryDequeue(logger->queue);
+
+        // Queue ran dry so this is the end of a batch, push out anything the sink buffered before waiting
+        if (!message) {
+            if (logger->pool) {
+                Mint_Loggo_PoolReturn(logger->pool);
+            }
+            Mint_Loggo_FlushSink(logger);
+            Mint_Loggo_WaitForMessages(logger->queue, logger->format);
+            message = Mint_Loggo_Dequeue(logger->queue);
+        }
+
+        #ifdef MINT__DEBUG
+            assert(logger);
+            assert(message);
+        #endif
+
+        if (message) {
+            // Done at this point
+            if (message->done) {
+                logger->done = true;
+                continue;
+            }
+
+            // Changes are made in queue order so they land between two messages
+            if (message->kind == MINT_LOGGO_MESSAGE_RECONFIGURE) {
+                Mint_Loggo_ApplyReconfigure(logger, message->payload);
+                Mint_Loggo_MarkDone(message->payload, false);
+                Mint_Loggo_FreeMessage(logger, message);
+                continue;
+            }
+
+            if (message->kind == MINT_LOGGO_MESSAGE_FORK) {
+                Mint_Loggo_FreeMessage(logger, message);
+                Mint_Loggo_ParkForFork(logger);
+                continue;
+            }
+
+            // Log the messages, then free them
+            Mint_Loggo_HandleLogMessage(logger, message);
+        }
+    }
+
+    // Abandoned loggers leave the sink alone, it is what held them up. What they leave queued goes
+    // here, a detached thread may be the last one to ever look at the queue
+    if (!MINT_LOGGO_ATOMIC_LOAD(&logger->abandon)) {
+        Mint_Loggo_FinishOutput(logger);
+    } else {
+        logger->abandoned = Mint_Loggo_DropQueued(logger);
+    }
+
+    Mint_Loggo_MarkExited(logger);
+    return EXIT_SUCCESS;
+}
+
+
+// Under the exit lock so a waiter cant check exited and go to sleep right after the broadcast
+static void Mint_Loggo_MarkExited(Mint_Loggo_Logger* logger) {
+    MINT_LOGGO_MUTEX_LOCK(MINT_LOGGO_WAIT_LOCK);
+    MINT_LOGGO_ATOMIC_STORE(&logger->exited, 1U);
+    MINT_LOGGO_COND_BROADCAST(MINT_LOGGO_WAIT_SIGNAL);
+    MINT_LOGGO_MUTEX_UNLOCK(MINT_LOGGO_WAIT_LOCK);
+}
+
+
+// Sleep until every running logger thread has exited, or until deadline (monotonic ms, 0 for never)
+static void Mint_Loggo_WaitForExits(Mint_Loggo_Logger** loggers, int32_t count, uint64_t deadline) {
+    MINT_LOGGO_MUTEX_LOCK(MINT_LOGGO_WAIT_LOCK);
+    for (int32_t idx = 0; idx < count; idx++) {
+        Mint_Loggo_Logger* logger = loggers[idx];
+        if (logger->state != MINT_LOGGO_LOGGER_RUNNING) {
+            continue;
+        }
+
+        while (!MINT_LOGGO_ATOMIC_LOAD(&logger->exited)) {
+            if (deadline == 0U) {
+                MINT_LOGGO_COND_WAIT(MINT_LOGGO_WAIT_SIGNAL, MINT_LOGGO_WAIT_LOCK);
+                continue;
+            }
+
+            uint64_t now = Mint_Loggo_MonotonicMs();
+            if (now >= deadline) {
+                MINT_LOGGO_MUTEX_UNLOCK(MINT_LOGGO_WAIT_LOCK);
+                return;
+            }
+            #if defined(_WIN32)
+                SleepConditionVariableCS(MINT_LOGGO_WAIT_SIGNAL, MINT_LOGGO_WAIT_LOCK, (DWORD)(deadline - now));
+            #else
+                // The condition waits on CLOCK_REALTIME, only the length of the wait comes from it
+                uint64_t until = Mint_Loggo_RealtimeNs() + (deadline - now) * 1000000U;
+                struct timespec wake = {.tv_sec = (time_t)(until / 1000000000U), .tv_nsec = (long)(until % 1000000000U)};
+                pthread_cond_timedwait(&MINT_LOGGO_WAIT_SIGNAL, &MINT_LOGGO_WAIT_LOCK, &wake);
+            #endif
+        }
+    }
+    MINT_LOGGO_MUTEX_UNLOCK(MINT_LOGGO_WAIT_LOCK);
+}
+
+
+// Last output of a logger that is going away
+static void Mint_Loggo_FinishOutput(Mint_Loggo_Logger* logger) {
+    // Close the trace array so the file loads without repairs
+    if (logger->format->output == MINT_LOGGO_OUTPUT_TRACE) {
+        const char* close = logger->trace_events ? "\n]\n" : "[]\n";
+        Mint_Loggo_WriteOut(logger, close, strlen(close));
+    }
+
+    // Dont leave batched output behind
+    Mint_Loggo_FlushSink(logger);
+}
+
+
+// Threadless
+
+
+// eventfd on Linux, a pipe elsewhere, made once and handed out to every caller
+// Made under the registry lock so two first callers cant both make one and leak the other
+MINT_LOGGO_DEF int Mint_Loggo_EventFd() {
+    #if defined(MINT_LOGGO_HAS_EVENT_FD)
+        Mint_Loggo_LockRegistry();
+        if (MINT_LOGGO_EVENT_FDS[0] == -1) {
+            #if defined(__linux__)
+                int fd = eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC);
+                MINT_LOGGO_EVENT_FDS[0] = fd;
+                MINT_LOGGO_EVENT_FDS[1] = fd;
+            #else
+                int fds[2];
+                if (pipe(fds) == 0) {
+                    for (int32_t idx = 0; idx < 2; idx++) {
+                        fcntl(fds[idx], F_SETFL, fcntl(fds[idx], F_GETFL) | O_NONBLOCK);
+                        fcntl(fds[idx], F_SETFD, FD_CLOEXEC);
+                        MINT_LOGGO_EVENT_FDS[idx] = fds[idx];
+                    }
+                }
+            #endif
+        }
+        int fd = MINT_LOGGO_EVENT_FDS[0];
+        Mint_Loggo_UnlockRegistry();
+        return fd;
+    #else
+        return -1;
+    #endif
+}
+
+
+// Start with whichever logger the last budget ran out on so a busy one cant starve the rest
+MINT_LOGGO_DEF uint32_t Mint_Loggo_Poll(uint32_t budget) {
+    Mint_Loggo_HashTable* table = &MINT_LOGGO_LOGGER_HASH_TABLE;
+    uint32_t handled = 0U;
+
+    // Walks every logger so it cant share the table with a create or delete
+    Mint_Loggo_LockRegistry();
+    if (!table->loggers) {
+        Mint_Loggo_UnlockRegistry();
+        return handled;
+    }
+
+    Mint_Loggo_ClearPending();
+    int32_t start = MINT_LOGGO_POLL_CURSOR % table->capacity;
+    for (int32_t step = 0; step < table->capacity; step++) {
+        int32_t idx = (start + step) % table->capacity;
+        Mint_Loggo_Logger* logger = table->loggers[idx];
+        if (!logger || logger == &MINT_LOGGO_LOGGER_DELETED || logger->owner || !logger->format->threadless ||
+            MINT_LOGGO_ATOMIC_LOAD(&logger->state) != MINT_LOGGO_LOGGER_RUNNING) {
+            continue;
+        }
+
+        handled += Mint_Loggo_DrainLogger(logger, budget ? budget - handled : 0U);
+        if (budget && handled >= budget) {
+            // Whatever is left keeps the descriptor readable
+            MINT_LOGGO_POLL_CURSOR = idx;
+            Mint_Loggo_SignalPending();
+            break;
+        }
+    }
+    Mint_Loggo_UnlockRegistry();
+    return handled;
+}
+
+
+// Write up to budget messages (0 for all of them) on the calling thread, returns how many
+// The sink lock keeps Poll, producers with a full queue and sync mode callers apart
+static uint32_t Mint_Loggo_DrainLogger(Mint_Loggo_Logger* logger, uint32_t budget) {
+    uint32_t handled = 0U;
+    Mint_Loggo_LogMessage* message = NULL;
+
+    MINT_LOGGO_MUTEX_LOCK(logger->sink_lock);
+    while ((budget == 0U || handled < budget) && (message = Mint_Loggo_TryDequeue(logger->queue))) {
+        MINT_LOGGO_STAMP(message, MINT_LOGGO_STAMP_TAKEN);
+        Mint_Loggo_EmitMessage(logger, message);
+        Mint_Loggo_FreeMessage(logger, message);
+        handled++;
+    }
+
+    // Ran dry, the same batch end a logger thread has
+    if (!message && handled) {
+        if (logger->pool) {
+            Mint_Loggo_PoolReturn(logger->pool);
+        }
+        logger->handler->flush_handler(logger->handler->handle);
+    }
+    MINT_LOGGO_MUTEX_UNLOCK(logger->sink_lock);
+    return handled;
+}
+
+
+// Only the first message after a Poll touches the descriptor
+static void Mint_Loggo_SignalPending() {
+    if (MINT_LOGGO_ATOMIC_LOAD(&MINT_LOGGO_EVENT_ARMED) || !MINT_LOGGO_ATOMIC_CAS(&MINT_LOGGO_EVENT_ARMED, 0U, 1U)) {
+        return;
+    }
+
+    #if defined(MINT_LOGGO_HAS_EVENT_FD)
+        if (MINT_LOGGO_EVENT_FDS[1] != -1) {
+            uint64_t one = 1U;
+            ssize_t result = write(MINT_LOGGO_EVENT_FDS[1], &one, sizeof(one));
+            (void)result;
+        }
+    #endif
+}
+
+
+// Disarm before draining so anything logged meanwhile signals again
+static void Mint_Loggo_ClearPending() {
+    if (!MINT_LOGGO_ATOMIC_CAS(&MINT_LOGGO_EVENT_ARMED, 1U, 0U)) {
+        return;
+    }
+
+    #if defined(MINT_LOGGO_HAS_EVENT_FD)
+        if (MINT_LOGGO_EVENT_FDS[0] != -1) {
+            uint64_t counts[8];
+            while (read(MINT_LOGGO_EVENT_FDS[0], counts, sizeof(counts)) > 0) {}
+        }
+    #endif
+}
+
+
+static void Mint_Loggo_CloseEventFd() {
+    #if defined(MINT_LOGGO_HAS_EVENT_FD)
+        if (MINT_LOGGO_EVENT_FDS[0] != -1) {
+            close(MINT_LOGGO_EVENT_FDS[0]);
+            if (MINT_LOGGO_EVENT_FDS[1] != MINT_LOGGO_EVENT_FDS[0]) {
+                close(MINT_LOGGO_EVENT_FDS[1]);
+            }
+        }
+    #endif
+    MINT_LOGGO_EVENT_FDS[0] = -1;
+    MINT_LOGGO_EVENT_FDS[1] = -1;
+    MINT_LOGGO_EVENT_ARMED = 0U;
+    MINT_LOGGO_POLL_CURSOR = 0;
+}
+
+
+// Fork
+
+
+// Undo StartLogger without a thread to join, used by a forked child for lazy loggers and for starts
+// the fork cut short, which may not have got as far as the pool or queue
+static void Mint_Loggo_StopLogger(Mint_Loggo_Logger* logger) {
+    Mint_Loggo_DestroyLinePieces(logger);
+    if (logger->pool) {
+        Mint_Loggo_DestroyPool(logger->pool, &logger->allocator);
+        logger->pool = NULL;
+    }
+    if (Mint_Loggo_LocksSink(logger)) {
+        MINT_LOGGO_MUTEX_DESTROY(logger->sink_lock);
+    }
+    if (logger->queue) {
+        Mint_Loggo_DestroyQueue(logger->queue);
+        logger->queue = NULL;
+    }
+    MINT_LOGGO_ATOMIC_STORE(&logger->state, MINT_LOGGO_LOGGER_IDLE);
+}
+
+
+// Runs on the logger thread, everything queued before the fork is out and no lock is held while parked
+static void Mint_Loggo_ParkForFork(Mint_Loggo_Logger* logger) {
+    Mint_Loggo_FlushSink(logger);
+    MINT_LOGGO_ATOMIC_STORE(&logger->fork_parked, 1U);
+    while (MINT_LOGGO_ATOMIC_LOAD(&MINT_LOGGO_FORK_HOLD)) {
+        MINT_LOGGO_SLEEP_MS(1U);
+    }
+    MINT_LOGGO_ATOMIC_STORE(&logger->fork_parked, 0U);
+}
+
+
+// pthread_atfork handlers cant be removed so they are registered once and find an empty table after Shutdown
+static void Mint_Loggo_WatchForks() {
+    #if defined(MINT_LOGGO_HAS_FORK)
+        if (!MINT_LOGGO_FORK_WATCHED) {
+            MINT_LOGGO_FORK_WATCHED = true;
+            pthread_atfork(Mint_Loggo_ForkPrepare, Mint_Loggo_ForkParent, Mint_Loggo_ForkChild);
+        }
+    #endif
+}
+
+
+// Park every logger thread behind what is already queued, then take the locks in the order the
+// rest of the code nests them (sink, queue, pool) so no producer is halfway through one at fork
+static void Mint_Loggo_ForkPrepare() {
+    Mint_Loggo_HashTable* table = &MINT_LOGGO_LOGGER_HASH_TABLE;
+    Mint_Loggo_LockRegistry();
+    if (!table->loggers) {
+        return;
+    }
+
+    // One deadline covers getting the FORK messages in and the threads parking behind them. A queue
+    // that stays full past it is skipped, its thread is forked wherever it is like one stuck in its sink
+    MINT_LOGGO_ATOMIC_STORE(&MINT_LOGGO_FORK_HOLD, 1U);
+    uint64_t deadline = Mint_Loggo_MonotonicMs() + MINT_LOGGO_FORK_QUIESCE_MS;
+    for (int32_t idx = 0; idx < table->capacity; idx++) {
+        Mint_Loggo_Logger* logger = table->loggers[idx];
+        if (!logger || logger == &MINT_LOGGO_LOGGER_DELETED || logger->owner || logger->format->threadless ||
+            MINT_LOGGO_ATOMIC_LOAD(&logger->state) != MINT_LOGGO_LOGGER_RUNNING || MINT_LOGGO_ATOMIC_LOAD(&logger->queue->closed)) {
+            continue;
+        }
+
+        Mint_Loggo_LogMessage* message = Mint_Loggo_AllocMessage(logger, sizeof(Mint_Loggo_LogMessage));
+        memset(message, 0U, sizeof(*message));
+        message->kind = MINT_LOGGO_MESSAGE_FORK;
+        while (!(logger->fork_queued = Mint_Loggo_TryEnqueue(logger->queue, message, MINT_LOGGO_LANE_BULK)) &&
+               Mint_Loggo_MonotonicMs() < deadline) {
+            MINT_LOGGO_SLEEP_MS(1U);
+        }
+        if (!logger->fork_queued) {
+            Mint_Loggo_ReleaseMessage(logger, message);
+        }
+    }
+
+    for (int32_t idx = 0; idx < table->capacity; idx++) {
+        Mint_Loggo_Logger* logger = table->loggers[idx];
+        if (!logger || logger == &MINT_LOGGO_LOGGER_DELETED || logger->owner || !logger->fork_queued) {
+            continue;
+        }
+
+        while (!MINT_LOGGO_ATOMIC_LOAD(&logger->fork_parked) && !MINT_LOGGO_ATOMIC_LOAD(&logger->exited) &&
+               Mint_Loggo_MonotonicMs() < deadline) {
+            MINT_LOGGO_SLEEP_MS(1U);
+        }
+        logger->fork_queued = false;
+    }
+
+    for (int32_t idx = 0; idx < table->capacity; idx++) {
+        Mint_Loggo_Logger* logger = table->loggers[idx];
+        if (!logger || logger == &MINT_LOGGO_LOGGER_DELETED || logger->owner || logger->state != MINT_LOGGO_LOGGER_RUNNING) {
+            continue;
+        }
+
+        if (Mint_Loggo_LocksSink(logger)) {
+            MINT_LOGGO_MUTEX_LOCK(logger->sink_lock);
+        }
+        MINT_LOGGO_MUTEX_LOCK(logger->queue->queue_lock);
+        if (logger->pool) {
+            MINT_LOGGO_MUTEX_LOCK(logger->pool->pool_lock);
+        }
+    }
+}
+
+
+static void Mint_Loggo_ForkParent() {
+    Mint_Loggo_HashTable* table = &MINT_LOGGO_LOGGER_HASH_TABLE;
+    if (!table->loggers) {
+        Mint_Loggo_UnlockRegistry();
+        return;
+    }
+
+    for (int32_t idx = 0; idx < table->capacity; idx++) {
+        Mint_Loggo_Logger* logger = table->loggers[idx];
+        if (!logger || logger == &MINT_LOGGO_LOGGER_DELETED || logger->owner || logger->state != MINT_LOGGO_LOGGER_RUNNING) {
+            continue;
+        }
+
+        if (logger->pool) {
+            MINT_LOGGO_MUTEX_UNLOCK(logger->pool->pool_lock);
+        }
+        MINT_LOGGO_MUTEX_UNLOCK(logger->queue->queue_lock);
+        if (Mint_Loggo_LocksSink(logger)) {
+            MINT_LOGGO_MUTEX_UNLOCK(logger->sink_lock);
+        }
+    }
+    MINT_LOGGO_ATOMIC_STORE(&MINT_LOGGO_FORK_HOLD, 0U);
+    Mint_Loggo_UnlockRegistry();
+}
+
+
+// Only the forking thread made it over, every lock is rebuilt rather than trusted
+static void Mint_Loggo_ForkChild() {
+    Mint_Loggo_HashTable* table = &MINT_LOGGO_LOGGER_HASH_TABLE;
+    MINT_LOGGO_FORK_HOLD = 0U;
+    MINT_LOGGO_MUTEX_INIT(MINT_LOGGO_REGISTRY_LOCK);
+    MINT_LOGGO_MUTEX_INIT(MINT_LOGGO_WAIT_LOCK);
+    MINT_LOGGO_COND_INIT(MINT_LOGGO_WAIT_SIGNAL);
+    MINT_LOGGO_LOOKUP_READERS[0] = 0U;
+    MINT_LOGGO_LOOKUP_READERS[1] = 0U;
+    MINT_LOGGO_THREAD_ID = 0U;
+    if (!table->loggers) {
+        return;
+    }
+
+    // The descriptor is shared with the parent, the application asks for the new one
+    bool had_event_fd = MINT_LOGGO_EVENT_FDS[0] != -1;
+    Mint_Loggo_CloseEventFd();
+    if (had_event_fd) {
+        Mint_Loggo_EventFd();
+    }
+
+    uint64_t pid = MINT_LOGGO_GET_PID();
+    for (int32_t idx = 0; idx < table->capacity; idx++) {
+        Mint_Loggo_Logger* logger = table->loggers[idx];
+        if (!logger || logger == &MINT_LOGGO_LOGGER_DELETED) {
+            continue;
+        }
+
+        logger->pid = pid;
+
+        // The thread stopping its owner didnt make it over, neither will the owner
+        if (logger->owner && logger->owner->unlinked) {
+            table->loggers[idx] = &MINT_LOGGO_LOGGER_DELETED;
+            table->size--;
+            table->deleted++;
+            continue;
+        }
+        if (logger->owner) {
+            continue;
+        }
+
+        // Shared sinks are reopened by whichever logger gets to them first
+        Mint_Loggo_LogHandler* handler = logger->handler;
+        if (handler->write_handler == Mint_Loggo_FileWrite || handler->write_len_handler == Mint_Loggo_FileWriteLen) {
+            Mint_Loggo_FileSink* sink = handler->handle;
+            if (sink->path && sink->pid != pid) {
+                Mint_Loggo_FileReopen(sink);
+                logger->trace_events = 0U;
+            }
+        }
+
+        // A start the fork cut short has no thread left to finish it, whatever it got to is undone
+        // and the next message starts it again. The starting thread doesnt run here to let it go
+        bool starting = logger->state == MINT_LOGGO_LOGGER_STARTING;
+        if (logger->state != MINT_LOGGO_LOGGER_RUNNING && !starting) {
+            continue;
+        }
+
+        if (Mint_Loggo_LocksSink(logger)) {
+            MINT_LOGGO_MUTEX_INIT(logger->sink_lock);
+        }
+        if (logger->queue) {
+            MINT_LOGGO_MUTEX_INIT(logger->queue->queue_lock);
+            MINT_LOGGO_COND_INIT(logger->queue->queue_not_full);
+            MINT_LOGGO_COND_INIT(logger->queue->queue_not_empty);
+            logger->queue->consumer_parked = false;
+        }
+        if (logger->pool) {
+            MINT_LOGGO_MUTEX_INIT(logger->pool->pool_lock);
+        }
+        if (starting) {
+            Mint_Loggo_StopLogger(logger);
+            continue;
+        }
+
+        // Whatever is still queued belongs to the parent
+        Mint_Loggo_DropQueued(logger);
+        logger->fork_parked = 0U;
+        if (logger->format->threadless || MINT_LOGGO_ATOMIC_LOAD(&logger->queue->closed)) {
+            continue;
+        }
+
+        if (logger->format->fork_lazy) {
+            Mint_Loggo_StopLogger(logger);
+        } else {
+            MINT_LOGGO_THREAD_CREATE(&logger->thread_id, Mint_Loggo_RunLogger, ((void*)logger));
+        }
+    }
+}
+
+
+// Pin and name the calling logger thread, failures are reported but not fatal
+static void Mint_Loggo_ConfigureThread(Mint_Loggo_LogFormat* format) {
+    if (format->cpu_affinity) {
+        #if defined(__linux__) && defined(CPU_SET)
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            for (uint32_t cpu = 0; cpu < 64U; cpu++) {
+                if (format->cpu_affinity & (1ULL << cpu)) {
+                    CPU_SET(cpu, &cpus);
+                }
+            }
+            if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+                fprintf(stderr, "[ERROR] Could not set logger thread affinity\n");
+            }
+        #elif defined(_WIN32)
+            if (!SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)format->cpu_affinity)) {
+                fprintf(stderr, "[ERROR] Could not set logger thread affinity\n");
+            }
+        #else
+            fprintf(stderr, "[ERROR] Logger thread affinity is not supported on this platform\n");
+        #endif
+    }
+
+    if (format->thread_name) {
+        #if defined(__linux__)
+            // Kernel truncates to 15 characters
+            prctl(PR_SET_NAME, format->thread_name, 0, 0, 0);
+        #elif defined(__APPLE__)
+            pthread_setname_np(format->thread_name);
+        #endif
+    }
+}
+
+
+// Queue a trace event, nothing is copied but the span pointer
+static void Mint_Loggo_Trace(const char* name, Mint_Loggo_MessageKind kind, const char* span) {
+    #ifdef MINT__DEBUG
+        assert(name);
+        assert(span);
+    #endif
+
+    Mint_Loggo_Logger* logger = Mint_Loggo_HTFindItem(name);
+
+    if (!logger) {
+        fprintf(stderr, "Invalid Logger Name: %s\n", name);
+        Mint_Loggo_DeleteLoggers();
+        exit(EXIT_FAILURE);
+    }
+
+    // Trace events are never filtered so they always wake the logger
+    Mint_Loggo_WakeLogger(logger);
+
+    Mint_Loggo_LogMessage* message = Mint_Loggo_AllocMessage(logger, sizeof(Mint_Loggo_LogMessage));
+    memset(message, 0U, sizeof(*message));
+    message->kind = kind;
+    message->timestamp = Mint_Loggo_Now(logger->format);
+    message->thread_id = Mint_Loggo_ThreadId();
+    message->msg = (char*)span;
+    Mint_Loggo_Submit(logger, message);
+}
+
+
+// Create a log message, the text is copied in behind the message and laid out on the logger thread
+static Mint_Loggo_LogMessage* Mint_Loggo_CreateLogMessage(Mint_Loggo_Logger* logger, Mint_Loggo_LogLevel level, const char* msg) {
+    size_t len = strlen(msg);
+
+    Mint_Loggo_LogMessage* message = Mint_Loggo_AllocMessage(logger, MINT_LOGGO_MESSAGE_HEADER_SIZE + len + 1U);
+    memset(message, 0U, sizeof(*message));
+    message->level = level;
+    message->timestamp = Mint_Loggo_Now(logger->format);
+    message->thread_id = Mint_Loggo_ThreadId();
+    message->context = Mint_Loggo_ContextAcquire();
+    message->msg = (char*)message + MINT_LOGGO_MESSAGE_HEADER_SIZE;
+    message->msg_len = len;
+    memcpy(message->msg, msg, len + 1U);
+    return message;
+}
+
+
+// Message memory
+
+
+// Pool slot when one is free and the message fits, otherwise the logger's allocator
+static void* Mint_Loggo_AllocMessage(Mint_Loggo_Logger* logger, size_t size) {
+    Mint_Loggo_MessagePool* pool = Mint_Loggo_OwnerOf(logger)->pool;
+    if (pool && size <= pool->slot_size) {
+        MINT_LOGGO_MUTEX_LOCK(pool->pool_lock);
+        Mint_Loggo_PoolSlot* slot = pool->free_slots;
+        if (slot) {
+            pool->free_slots = slot->next;
+        }
+        MINT_LOGGO_MUTEX_UNLOCK(pool->pool_lock);
+
+        if (slot) {
+            return slot;
+        }
+    }
+
+    return Mint_Loggo_AllocatorMalloc(&logger->allocator, size);
+}
+
+
+// Only the logger thread frees messages, slots are held back until a batch is ready
+static void Mint_Loggo_FreeMessage(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message) {
+    Mint_Loggo_MessagePool* pool = logger->pool;
+    if (message->adopted) {
+        free(message->msg);
+    }
+    if (message->context) {
+        Mint_Loggo_ContextRelease(message->context);
+    }
+
+    char* address = (char*)message;
+    if (!pool || address < pool->block || address >= pool->block + pool->slot_size * pool->slots) {
+        logger->allocator.free(message, logger->allocator.ctx);
+        return;
+    }
+
+    Mint_Loggo_PoolSlot* slot = (Mint_Loggo_PoolSlot*)message;
+    slot->next = pool->returned;
+    if (!pool->returned) {
+        pool->returned_tail = slot;
+    }
+    pool->returned = slot;
+
+    if (++pool->returned_count >= MINT_LOGGO_POOL_RETURN_BATCH) {
+        Mint_Loggo_PoolReturn(pool);
+    }
+}
+
+
+// Free from a thread other than the logger thread, slots go straight back to the shared list
+static void Mint_Loggo_ReleaseMessage(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message) {
+    Mint_Loggo_MessagePool* pool = logger->pool;
+    if (message->adopted) {
+        free(message->msg);
+    }
+    if (message->context) {
+        Mint_Loggo_ContextRelease(message->context);
+    }
+
+    char* address = (char*)message;
+    if (!pool || address < pool->block || address >= pool->block + pool->slot_size * pool->slots) {
+        logger->allocator.free(message, logger->allocator.ctx);
+        return;
+    }
+
+    Mint_Loggo_PoolSlot* slot = (Mint_Loggo_PoolSlot*)message;
+    MINT_LOGGO_MUTEX_LOCK(pool->pool_lock);
+    slot->next = pool->free_slots;
+    pool->free_slots = slot;
+    MINT_LOGGO_MUTEX_UNLOCK(pool->pool_lock);
+}
+
+
+// Splice the gathered slots back onto the shared list with one lock
+static void Mint_Loggo_PoolReturn(Mint_Loggo_MessagePool* pool) {
+    if (!pool->returned) {
+        return;
+    }
+
+    MINT_LOGGO_MUTEX_LOCK(pool->pool_lock);
+    pool->returned_tail->next = pool->free_slots;
+    pool->free_slots = pool->returned;
+    MINT_LOGGO_MUTEX_UNLOCK(pool->pool_lock);
+
+    pool->returned = NULL;
+    pool->returned_tail = NULL;
+    pool->returned_count = 0U;
+}
+
+
+// One block split into slots, slot size keeps the header alignment
+static Mint_Loggo_MessagePool* Mint_Loggo_CreatePool(const Mint_Loggo_Allocator* allocator, uint32_t slots, size_t slot_size) {
+    if (slot_size < MINT_LOGGO_MESSAGE_HEADER_SIZE) {
+        slot_size = MINT_LOGGO_DEFAULT_POOL_SLOT_SIZE;
+    }
+    slot_size = (slot_size + 15U) & ~(size_t)15U;
+
+    Mint_Loggo_MessagePool* pool = Mint_Loggo_AllocatorMalloc(allocator, sizeof(Mint_Loggo_MessagePool));
+    memset(pool, 0U, sizeof(*pool));
+    pool->block = Mint_Loggo_AllocatorMalloc(allocator, slot_size * slots);
+    pool->slot_size = slot_size;
+    pool->slots = slots;
+    MINT_LOGGO_MUTEX_INIT(pool->pool_lock);
+
+    for (uint32_t idx = slots; idx > 0U; idx--) {
+        Mint_Loggo_PoolSlot* slot = (Mint_Loggo_PoolSlot*)(pool->block + slot_size * (idx - 1U));
+        slot->next = pool->free_slots;
+        pool->free_slots = slot;
+    }
+    return pool;
+}
+
+
+static void Mint_Loggo_DestroyPool(Mint_Loggo_MessagePool* pool, const Mint_Loggo_Allocator* allocator) {
+    MINT_LOGGO_MUTEX_DESTROY(pool->pool_lock);
+    allocator->free(pool->block, allocator->ctx);
+    memset(pool, 0U, sizeof(*pool));
+    allocator->free(pool, allocator->ctx);
+}
+
+
+// Called under the registry lock once the logger is out of the table, either way it is handed back
+// for CleanUpLogger to finish without the lock. An owner is stopped there, its children stay in the
+// table until then. A child holds its owner so the owner outlives the wait for its messages
+static Mint_Loggo_Logger* Mint_Loggo_UnlinkLogger(Mint_Loggo_Logger* logger) {
+    if (logger->owner) {
+        MINT_LOGGO_ATOMIC_ADD(&logger->owner->holds, 1U);
+        return logger;
+    }
+
+    logger->unlinked = true;
+    return logger;
+}
+
+
+// Free all the handles of an unlinked owner, the join runs without the registry lock
+// Callers still holding it finish against a live logger first
+static void Mint_Loggo_CleanUpLogger(Mint_Loggo_Logger* logger) {
+    // A child goes once its owner is past the messages logged through it
+    if (logger->owner) {
+        Mint_Loggo_Logger* owner = logger->owner;
+        bool passed = MINT_LOGGO_ATOMIC_LOAD(&owner->state) != MINT_LOGGO_LOGGER_RUNNING || Mint_Loggo_QueueReconfigure(owner, NULL, -1);
+
+        // A closed queue can still hold them, the owner takes the child with it instead
+        Mint_Loggo_LockRegistry();
+        if (passed) {
+            Mint_Loggo_FreeLogger(logger);
+        } else {
+            logger->next_orphan = owner->orphans;
+            owner->orphans = logger;
+        }
+        Mint_Loggo_UnlockRegistry();
+        Mint_Loggo_LetGo(owner);
+        return;
+    }
+
+    Mint_Loggo_WaitForHolds(logger);
+
+    // Let the logger drain and wait for it to close, idle loggers never got a thread or queue
+    if (logger->state == MINT_LOGGO_LOGGER_RUNNING && logger->format->threadless) {
+        Mint_Loggo_DrainLogger(logger, 0U);
+        Mint_Loggo_FinishOutput(logger);
+    } else if (logger->state == MINT_LOGGO_LOGGER_RUNNING) {
+        Mint_Loggo_CloseQueue(logger->queue);
+        MINT_LOGGO_THREAD_JOIN(logger->thread_id);
+    }
+
+    Mint_Loggo_LockRegistry();
+    Mint_Loggo_DropChildren(logger, true);
+    Mint_Loggo_FreeLogger(logger);
+
+    // Last one out deletes the table and clears it so its inited next time
+    if (MINT_LOGGO_LOGGER_HASH_TABLE.size == 0) {
+        Mint_Loggo_HTDeleteTable();
+        memset(&MINT_LOGGO_LOGGER_HASH_TABLE, 0U, sizeof(Mint_Loggo_HashTable));
+    } else {
+        Mint_Loggo_ResolveLevels();
+    }
+    Mint_Loggo_UnlockRegistry();
+}
+
+
+// Lookup for the setters, an owner found under the registry lock cant be unlinked until it is let go
+static Mint_Loggo_Logger* Mint_Loggo_HoldOwner(const char* name) {
+    Mint_Loggo_LockRegistry();
+    Mint_Loggo_Logger* logger = Mint_Loggo_HTFindItem(name);
+    if (logger && logger->owner) {
+        logger = NULL;
+    }
+    if (logger) {
+        MINT_LOGGO_ATOMIC_ADD(&logger->holds, 1U);
+    }
+    Mint_Loggo_UnlockRegistry();
+    return logger;
+}
+
+
+static void Mint_Loggo_LetGo(Mint_Loggo_Logger* logger) {
+    MINT_LOGGO_MUTEX_LOCK(MINT_LOGGO_WAIT_LOCK);
+    MINT_LOGGO_ATOMIC_ADD(&logger->holds, -1);
+    MINT_LOGGO_COND_BROADCAST(MINT_LOGGO_WAIT_SIGNAL);
+    MINT_LOGGO_MUTEX_UNLOCK(MINT_LOGGO_WAIT_LOCK);
+}
+
+
+// Only called once the logger is out of the table, so no new holds can be taken meanwhile
+static void Mint_Loggo_WaitForHolds(Mint_Loggo_Logger* logger) {
+    MINT_LOGGO_MUTEX_LOCK(MINT_LOGGO_WAIT_LOCK);
+    while (MINT_LOGGO_ATOMIC_LOAD(&logger->holds)) {
+        MINT_LOGGO_COND_WAIT(MINT_LOGGO_WAIT_SIGNAL, MINT_LOGGO_WAIT_LOCK);
+    }
+    MINT_LOGGO_MUTEX_UNLOCK(MINT_LOGGO_WAIT_LOCK);
+}
+
+
+// Children cant outlive the queue they write to, they are left allocated when a stuck thread may still render them
+static void Mint_Loggo_DropChildren(Mint_Loggo_Logger* owner, bool release) {
+    Mint_Loggo_HashTable* table = &MINT_LOGGO_LOGGER_HASH_TABLE;
+    for (int32_t idx = 0; idx < table->capacity && table->loggers; idx++) {
+        Mint_Loggo_Logger* logger = table->loggers[idx];
+        if (logger && logger != &MINT_LOGGO_LOGGER_DELETED && logger->owner == owner) {
+            MINT_LOGGO_ATOMIC_STORE(&table->loggers[idx], &MINT_LOGGO_LOGGER_DELETED);
+            table->size--;
+            table->deleted++;
+            if (release) {
+                Mint_Loggo_FreeLogger(logger);
+            }
+        }
+    }
+}
+
+
+// Throw away what an abandoned logger left queued, its thread is gone so the pool is ours
+static uint64_t Mint_Loggo_DropQueued(Mint_Loggo_Logger* logger) {
+    uint64_t dropped = 0U;
+    Mint_Loggo_LogMessage* message = NULL;
+    while ((message = Mint_Loggo_TryDequeue(logger->queue))) {
+        // Dont leave a reconfiguring caller waiting on a thread that is gone, it closes its own handler
+        if (message->kind == MINT_LOGGO_MESSAGE_RECONFIGURE) {
+            Mint_Loggo_MarkDone(message->payload, true);
+            Mint_Loggo_FreeMessage(logger, message);
+            continue;
+        }
+        if (message->kind == MINT_LOGGO_MESSAGE_FORK) {
+            Mint_Loggo_FreeMessage(logger, message);
+            continue;
+        }
+        Mint_Loggo_FreeMessage(logger, message);
+        dropped++;
+    }
+    return dropped;
+}
+
+
+// Everything but the thread, which has to be joined already
+static void Mint_Loggo_FreeLogger(Mint_Loggo_Logger* logger) {
+    // Everything else belongs to the owner
+    if (logger->owner) {
+        if (logger->pieces_generation) {
+            Mint_Loggo_DestroyLinePieces(logger);
+        }
+        Mint_Loggo_HTRetire(logger);
+        return;
+    }
+
+    bool started = logger->state == MINT_LOGGO_LOGGER_RUNNING;
+    bool sync = Mint_Loggo_LocksSink(logger);
+
+    // Leftovers go back to the pool or allocator they came from before either is gone
+    if (started) {
+        Mint_Loggo_DropQueued(logger);
+    }
+    while (logger->orphans) {
+        Mint_Loggo_Logger* orphan = logger->orphans;
+        logger->orphans = orphan->next_orphan;
+        Mint_Loggo_FreeLogger(orphan);
+    }
+
+    // Free handles
+    Mint_Loggo_DestroyLogHandler(logger->handler);
+    logger->handler = NULL;
+
+    Mint_Loggo_DestroyLinePieces(logger);
+
+    Mint_Loggo_DestroyLogFormat(logger->format);
+    logger->format = NULL;
+
+    if (started) {
+        if (sync) {
+            MINT_LOGGO_MUTEX_DESTROY(logger->sink_lock);
+        }
+        Mint_Loggo_DestroyQueue(logger->queue);
+        logger->queue = NULL;
+    }
+
+    if (logger->pool) {
+        Mint_Loggo_DestroyPool(logger->pool, &logger->allocator);
+        logger->pool = NULL;
+    }
+
+    if (logger->scratch) {
+        MINT_LOGGO_FREE(logger->scratch);
+        logger->scratch = NULL;
+    }
+
+    if (logger->render) {
+        MINT_LOGGO_FREE(logger->render);
+        logger->render = NULL;
+    }
+
+    #ifdef MINT_LOGGO_LATENCY_STATS
+        MINT_LOGGO_FREE(logger->latency);
+        logger->latency = NULL;
+    #endif
+
+    // Another thread looking up a different name may be reading it
+    Mint_Loggo_HTRetire(logger);
+}
+
+
+// Time
+
+
+static uint64_t Mint_Loggo_MonotonicMs() {
+    #if defined(_WIN32)
+        return (uint64_t)GetTickCount64();
+    #else
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return ((uint64_t)now.tv_sec * 1000U) + ((uint64_t)now.tv_nsec / 1000000U);
+    #endif
+}
+
+
+static uint64_t Mint_Loggo_RealtimeNs() {
+    struct timespec now;
+    #if defined(_WIN32)
+        timespec_get(&now, TIME_UTC);
+    #else
+        clock_gettime(CLOCK_REALTIME, &now);
+    #endif
+    return ((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec;
+}
+
+
+// Raw cycle counter, 0 where there is none
+static uint64_t Mint_Loggo_ReadCycles() {
+    #if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        return (uint64_t)__rdtsc();
+    #elif defined(__aarch64__)
+        uint64_t cycles;
+        __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(cycles));
+        return cycles;
+    #else
+        return 0U;
+    #endif
+}
+
+
+// The counter has to tick at a constant rate across power states and cores
+static bool Mint_Loggo_CyclesInvariant() {
+    #if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        int regs[4];
+        __cpuid(regs, 0x80000000);
+        if ((unsigned int)regs[0] < 0x80000007U) return false;
+        __cpuid(regs, 0x80000007);
+        return (regs[3] & (1 << 8)) != 0;
+    #elif defined(__x86_64__) || defined(__i386__)
+        unsigned int eax = 0U, ebx = 0U, ecx = 0U, edx = 0U;
+        if (__get_cpuid_max(0x80000000U, NULL) < 0x80000007U) return false;
+        if (!__get_cpuid(0x80000007U, &eax, &ebx, &ecx, &edx)) return false;
+        return (edx & (1U << 8)) != 0;
+    #elif defined(__aarch64__)
+        // The generic timer is constant rate by definition
+        return true;
+    #else
+        return false;
+    #endif
+}
+
+
+// Measure the counter against CLOCK_REALTIME once, loggers refine it as they run
+// Runs under the registry lock so concurrent creates calibrate once and never copy a half written
+// clock, the copy goes to clock when given. False when the counter cant be trusted
+static bool Mint_Loggo_CalibrateCycles(Mint_Loggo_CycleClock* clock) {
+    Mint_Loggo_LockRegistry();
+    if (MINT_LOGGO_CYCLE_CLOCK.ns_per_cycle == 0.0 && !MINT_LOGGO_CYCLE_CLOCK.untrusted) {
+        Mint_Loggo_MeasureCycles();
+    }
+    if (clock) {
+        *clock = MINT_LOGGO_CYCLE_CLOCK;
+    }
+    bool usable = MINT_LOGGO_CYCLE_CLOCK.ns_per_cycle != 0.0;
+    Mint_Loggo_UnlockRegistry();
+    return usable;
+}
+
+
+// Called once with the registry lock held, marks the clock untrusted instead of trying again
+static void Mint_Loggo_MeasureCycles() {
+    if (!Mint_Loggo_CyclesInvariant()) {
+        MINT_LOGGO_CYCLE_CLOCK.untrusted = true;
+        return;
+    }
+
+    uint64_t start_ns = Mint_Loggo_RealtimeNs();
+    uint64_t start_cycles = Mint_Loggo_ReadCycles();
+    uint64_t end_ns = start_ns;
+    while (end_ns - start_ns < MINT_LOGGO_TSC_CALIBRATION_NS) {
+        end_ns = Mint_Loggo_RealtimeNs();
+    }
+    uint64_t end_cycles = Mint_Loggo_ReadCycles();
+
+    if (end_cycles <= start_cycles) {
+        MINT_LOGGO_CYCLE_CLOCK.untrusted = true;
+        return;
+    }
+
+    MINT_LOGGO_CYCLE_CLOCK.anchor_cycles = end_cycles;
+    MINT_LOGGO_CYCLE_CLOCK.anchor_ns = end_ns;
+    MINT_LOGGO_CYCLE_CLOCK.ns_per_cycle = (double)(end_ns - start_ns) / (double)(end_cycles - start_cycles);
+    MINT_LOGGO_CYCLE_CLOCK.next_calibration_cycles = end_cycles + (uint64_t)(MINT_LOGGO_TSC_RECALIBRATION_NS / MINT_LOGGO_CYCLE_CLOCK.ns_per_cycle);
+}
+
+
+// Producer side stamp, only as expensive as the source asks for
+static uint64_t Mint_Loggo_Now(Mint_Loggo_LogFormat* format) {
+    switch (format->time_source) {
+        case MINT_LOGGO_TIME_SOURCE_TSC:
+            return Mint_Loggo_ReadCycles();
+        case MINT_LOGGO_TIME_SOURCE_CLOCK:
+            return Mint_Loggo_RealtimeNs();
+        default:
+            return (uint64_t)time(NULL) * 1000000000U;
+    }
+}
+
+
+// Logger thread side, turns a stamp into nanoseconds since the epoch
+// Every second of counter time the logger takes a fresh clock reading and refits the rate against
+// the global anchor so drift between the counter and the wall clock never builds up
+static uint64_t Mint_Loggo_StampToNs(Mint_Loggo_Logger* logger, uint64_t stamp) {
+    if (logger->format->time_source != MINT_LOGGO_TIME_SOURCE_TSC) {
+        return stamp;
+    }
+
+    Mint_Loggo_CycleClock* clock = &logger->clock;
+    if (stamp >= clock->next_calibration_cycles) {
+        uint64_t now_ns = Mint_Loggo_RealtimeNs();
+        uint64_t now_cycles = Mint_Loggo_ReadCycles();
+        if (now_cycles > MINT_LOGGO_CYCLE_CLOCK.anchor_cycles && now_ns > MINT_LOGGO_CYCLE_CLOCK.anchor_ns) {
+            clock->ns_per_cycle = (double)(now_ns - MINT_LOGGO_CYCLE_CLOCK.anchor_ns) / (double)(now_cycles - MINT_LOGGO_CYCLE_CLOCK.anchor_cycles);
+        }
+        clock->anchor_ns = now_ns;
+        clock->anchor_cycles = now_cycles;
+        clock->next_calibration_cycles = now_cycles + (uint64_t)(MINT_LOGGO_TSC_RECALIBRATION_NS / clock->ns_per_cycle);
+    }
+
+    // Stamps taken before the latest anchor land behind it
+    int64_t delta = (int64_t)(stamp - clock->anchor_cycles);
+    return (uint64_t)((int64_t)clock->anchor_ns + (int64_t)((double)delta * clock->ns_per_cycle));
+}
+
+
+// Latency
+
+
+#ifdef MINT_LOGGO_LATENCY_STATS
+
+MINT_LOGGO_DEF bool Mint_Loggo_GetLatency(const char* name, Mint_Loggo_LatencyStage stage, Mint_Loggo_LatencySummary* summary) {
+    Mint_Loggo_Logger* logger = name ? Mint_Loggo_HTFindItem(name) : NULL;
+    if (!logger || !summary || stage >= MINT_LOGGO_LATENCY_STAGES) {
+        return false;
+    }
+
+    Mint_Loggo_SummarizeLatency(Mint_Loggo_OwnerOf(logger)->latency, stage, summary);
+    return true;
+}
+
+
+MINT_LOGGO_DEF bool Mint_Loggo_ResetLatency(const char* name) {
+    Mint_Loggo_Logger* logger = name ? Mint_Loggo_HTFindItem(name) : NULL;
+    if (!logger) {
+        return false;
+    }
+
+    MINT_LOGGO_ATOMIC_STORE(&Mint_Loggo_OwnerOf(logger)->latency->reset, 1U);
+    return true;
+}
+
+
+// A report into the reporting logger's own queue could wait on itself, so that is refused
+MINT_LOGGO_DEF bool Mint_Loggo_ReportLatency(const char* name, const char* report_to, uint32_t interval_ms) {
+    Mint_Loggo_Logger* logger = name ? Mint_Loggo_HTFindItem(name) : NULL;
+    if (!logger) {
+        return false;
+    }
+    logger = Mint_Loggo_OwnerOf(logger);
+
+    if (interval_ms) {
+        Mint_Loggo_Logger* target = report_to ? Mint_Loggo_HTFindItem(report_to) : NULL;
+        if (!target || Mint_Loggo_OwnerOf(target) == logger) {
+            return false;
+        }
+    }
+
+    Mint_Loggo_LatencyStats* stats = logger->latency;
+    MINT_LOGGO_ATOMIC_STORE(&stats->report_to, report_to);
+    MINT_LOGGO_ATOMIC_STORE(&stats->next_report_ns, 0U);
+    MINT_LOGGO_ATOMIC_STORE(&stats->report_interval_ms, interval_ms);
+    return true;
+}
+
+
+static uint64_t Mint_Loggo_MonotonicNs() {
+    #if defined(_WIN32)
+        LARGE_INTEGER now;
+        LARGE_INTEGER frequency;
+        QueryPerformanceCounter(&now);
+        QueryPerformanceFrequency(&frequency);
+        return (uint64_t)((double)now.QuadPart * 1e9 / (double)frequency.QuadPart);
+    #else
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return ((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec;
+    #endif
+}
+
+
+// Exact below 64, above that the top six bits of the value pick the bucket
+static uint32_t Mint_Loggo_LatencyBucket(uint64_t value) {
+    if (value < 2U * MINT_LOGGO_LATENCY_SUB_BUCKETS) {
+        return (uint32_t)value;
+    }
+
+    uint32_t shift = 0U;
+    while ((value >> shift) >= 2U * MINT_LOGGO_LATENCY_SUB_BUCKETS) {
+        shift++;
+    }
+    if (shift > MINT_LOGGO_LATENCY_MAX_SHIFT) {
+        return MINT_LOGGO_LATENCY_BUCKETS - 1U;
+    }
+    return 2U * MINT_LOGGO_LATENCY_SUB_BUCKETS + (shift - 1U) * MINT_LOGGO_LATENCY_SUB_BUCKETS +
+           (uint32_t)(value >> shift) - MINT_LOGGO_LATENCY_SUB_BUCKETS;
+}
+
+
+// Largest value that lands in bucket
+static uint64_t Mint_Loggo_LatencyBucketTop(uint32_t bucket) {
+    if (bucket < 2U * MINT_LOGGO_LATENCY_SUB_BUCKETS) {
+        return bucket;
+    }
+
+    uint32_t offset = bucket - 2U * MINT_LOGGO_LATENCY_SUB_BUCKETS;
+    uint32_t shift = offset / MINT_LOGGO_LATENCY_SUB_BUCKETS + 1U;
+    uint64_t top = offset % MINT_LOGGO_LATENCY_SUB_BUCKETS + MINT_LOGGO_LATENCY_SUB_BUCKETS;
+    return ((top + 1U) << shift) - 1U;
+}
+
+
+// Called by whoever just wrote the message, which is only ever one thread at a time per logger
+static void Mint_Loggo_RecordLatency(Mint_Loggo_Logger* logger, Mint_Loggo_LogMessage* message) {
+    Mint_Loggo_LatencyStats* stats = logger->latency;
+    uint64_t written = Mint_Loggo_MonotonicNs();
+    if (MINT_LOGGO_ATOMIC_LOAD(&stats->reset)) {
+        memset(stats->counts, 0U, sizeof(stats->counts));
+        memset(stats->sums, 0U, sizeof(stats->sums));
+        memset(stats->mins, 0U, sizeof(stats->mins));
+        memset(stats->maxes, 0U, sizeof(stats->maxes));
+        MINT_LOGGO_ATOMIC_STORE(&stats->messages, 0U);
+        MINT_LOGGO_ATOMIC_STORE(&stats->reset, 0U);
+    }
+
+    // Each stamp is taken after the one before it, the clamps only guard against a clock going back
+    uint64_t* stamps = message->stamps;
+    uint64_t taken = stamps[MINT_LOGGO_STAMP_TAKEN] > stamps[MINT_LOGGO_STAMP_SUBMITTED] ? stamps[MINT_LOGGO_STAMP_TAKEN] : stamps[MINT_LOGGO_STAMP_SUBMITTED];
+    uint64_t formatted = stamps[MINT_LOGGO_STAMP_FORMATTED] > taken ? stamps[MINT_LOGGO_STAMP_FORMATTED] : taken;
+    written = written > formatted ? written : formatted;
+    uint64_t values[MINT_LOGGO_LATENCY_STAGES] = {
+        taken - stamps[MINT_LOGGO_STAMP_SUBMITTED], formatted - taken, written - formatted, written - stamps[MINT_LOGGO_STAMP_SUBMITTED]
+    };
+
+    bool first = stats->messages == 0U;
+    for (uint32_t stage = 0; stage < MINT_LOGGO_LATENCY_STAGES; stage++) {
+        uint64_t* count = &stats->counts[stage][Mint_Loggo_LatencyBucket(values[stage])];
+        MINT_LOGGO_ATOMIC_STORE(count, *count + 1U);
+        MINT_LOGGO_ATOMIC_STORE(&stats->sums[stage], stats->sums[stage] + values[stage]);
+        if (first || values[stage] < stats->mins[stage]) {
+            MINT_LOGGO_ATOMIC_STORE(&stats->mins[stage], values[stage]);
+        }
+        if (values[stage] > stats->maxes[stage]) {
+            MINT_LOGGO_ATOMIC_STORE(&stats->maxes[stage], values[stage]);
+        }
+    }
+    MINT_LOGGO_ATOMIC_STORE(&stats->messages, stats->messages + 1U);
+
+    // The first message after ReportLatency starts the interval
+    uint32_t interval_ms = MINT_LOGGO_ATOMIC_LOAD(&stats->report_interval_ms);
+    if (interval_ms) {
+        uint64_t next_report_ns = MINT_LOGGO_ATOMIC_LOAD(&stats->next_report_ns);
+        if (next_report_ns && written >= next_report_ns) {
+            Mint_Loggo_EmitLatencyReport(logger);
+        }
+        if (!next_report_ns || written >= next_report_ns) {
+            MINT_LOGGO_ATOMIC_STORE(&stats->next_report_ns, written + (uint64_t)interval_ms * 1000000U);
+        }
+    }
+}
+
+
+// Counts are read as they are, a writer recording meanwhile can leave a summary a message behind
+static void Mint_Loggo_SummarizeLatency(Mint_Loggo_LatencyStats* stats, Mint_Loggo_LatencyStage stage, Mint_Loggo_LatencySummary* summary) {
+    memset(summary, 0U, sizeof(*summary));
+    uint64_t counts[MINT_LOGGO_LATENCY_BUCKETS];
+    for (uint32_t bucket = 0; bucket < MINT_LOGGO_LATENCY_BUCKETS; bucket++) {
+        counts[bucket] = MINT_LOGGO_ATOMIC_LOAD(&stats->counts[stage][bucket]);
+        summary->count += counts[bucket];
+    }
+    if (!summary->count) {
+        return;
+    }
+
+    summary->min_ns = MINT_LOGGO_ATOMIC_LOAD(&stats->mins[stage]);
+    summary->max_ns = MINT_LOGGO_ATOMIC_LOAD(&stats->maxes[stage]);
+    summary->mean_ns = MINT_LOGGO_ATOMIC_LOAD(&stats->sums[stage]) / summary->count;
+
+    // Smallest bucket top with at least the wanted share of messages at or below it
+    static const uint32_t per_mille[4] = {500U, 900U, 990U, 999U};
+    uint64_t* percentiles[4] = {&summary->p50_ns, &summary->p90_ns, &summary->p99_ns, &summary->p999_ns};
+    uint64_t seen = 0U;
+    uint32_t wanted = 0U;
+    for (uint32_t bucket = 0; bucket < MINT_LOGGO_LATENCY_BUCKETS && wanted < 4U; bucket++) {
+        seen += counts[bucket];
+        while (wanted < 4U && seen * 1000U >= summary->count * per_mille[wanted]) {
+            uint64_t top = Mint_Loggo_LatencyBucketTop(bucket);
+            *percentiles[wanted++] = top < summary->max_ns ? top : summary->max_ns;
+        }
+    }
+}
+
+
+// One line per interval, the histograms start over after it
+// Runs on the logger thread, so the target is looked up again and never waited on: a deleted target
+// skips the report and a full queue drops it, two loggers reporting to each other cant block
+static void Mint_Loggo_EmitLatencyReport(Mint_Loggo_Logger* logger) {
+    static const char* const stage_names[MINT_LOGGO_LATENCY_STAGES] = {"queue", "format", "write", "total"};
+    Mint_Loggo_LatencyStats* stats = logger->latency;
+    const char* report_to = MINT_LOGGO_ATOMIC_LOAD(&stats->report_to);
+    Mint_Loggo_Logger* target = report_to ? Mint_Loggo_HTFindItem(report_to) : NULL;
+    if (!target || Mint_Loggo_OwnerOf(target) == logger) {
+        return;
+    }
+
+    // A long logger name cuts the line short rather than overrunning it
+    char line[512U];
+    size_t len = (size_t)snprintf(line, sizeof(line), "latency %s n=%llu", logger->name, (unsigned long long)stats->messages);
+    for (uint32_t stage = 0; stage < MINT_LOGGO_LATENCY_STAGES && len < sizeof(line); stage++) {
+        Mint_Loggo_LatencySummary summary;
+        Mint_Loggo_SummarizeLatency(stats, (Mint_Loggo_LatencyStage)stage, &summary);
+        len += (size_t)snprintf(line + len, sizeof(line) - len, " %s p50=%lluns p99=%lluns p999=%lluns max=%lluns", stage_names[stage],
+                                (unsigned long long)summary.p50_ns, (unsigned long long)summary.p99_ns,
+                                (unsigned long long)summary.p999_ns, (unsigned long long)summary.max_ns);
+    }
+
+    MINT_LOGGO_ATOMIC_STORE(&stats->reset, 1U);
+    if (MINT_LOGGO_LEVEL_INFO < MINT_LOGGO_ATOMIC_LOAD(&target->level)) {
+        return;
+    }
+
+    Mint_Loggo_Logger* owner = Mint_Loggo_OwnerOf(target);
+    Mint_Loggo_WakeLogger(owner);
+    Mint_Loggo_LogMessage* message = Mint_Loggo_CreateLogMessage(target, MINT_LOGGO_LEVEL_INFO, line);
+    if (target->owner) {
+        message->source = target;
+    }
+    MINT_LOGGO_STAMP(message, MINT_LOGGO_STAMP_SUBMITTED);
+    if (!Mint_Loggo_TryEnqueue(owner->queue, message, MINT_LOGGO_LANE_BULK)) {
+        Mint_Loggo_ReleaseMessage(owner, message);
+    } else if (owner->format->threadless) {
+        Mint_Loggo_SignalPending();
+    }
+}
+
+#endif
+
+
+// Socket sink
+
+
+#ifdef MINT_LOGGO_HAS_SOCKETS
+
+// Copy the config, fill in defaults and make a first connection attempt
+MINT_LOGGO_DEF Mint_Loggo_SocketSink* Mint_Loggo_SocketOpen(const Mint_Loggo_SocketConfig* config) {
+    if (!config || !config->path || strlen(config->path) >= sizeof(((struct sockaddr_un*)0)->sun_path)) {
+        return NULL;
+    }
+
+    Mint_Loggo_SocketSink* sink = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_SocketSink));
+    memset(sink, 0U, sizeof(*sink));
+    memcpy(&sink->config, config, sizeof(*config));
+
+    if (sink->config.frame_size == 0) sink->config.frame_size = MINT_LOGGO_DEFAULT_SOCKET_FRAME_SIZE;
+    if (sink->config.buffer_size == 0) sink->config.buffer_size = MINT_LOGGO_DEFAULT_SOCKET_BUFFER_SIZE;
+    if (sink->config.reconnect_ms == 0) sink->config.reconnect_ms = MINT_LOGGO_DEFAULT_SOCKET_RECONNECT_MS;
+
+    // Own the path so callers can pass temporaries
+    sink->path = MINT_LOGGO_MALLOC(strlen(config->path) + 1U);
+    strcpy(sink->path, config->path);
+    sink->config.path = sink->path;
+
+    // Always keep two frames so one can be sent while the other fills
+    sink->frame_count = sink->config.buffer_size / sink->config.frame_size;
+    if (sink->frame_count < 2U) sink->frame_count = 2U;
+    sink->frames = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_SocketFrame) * sink->frame_count);
+    memset(sink->frames, 0U, sizeof(Mint_Loggo_SocketFrame) * sink->frame_count);
+
+    sink->fd = -1;
+    sink->backoff_ms = sink->config.reconnect_ms;
+    Mint_Loggo_SocketConnect(sink);
+    return sink;
+}
+
+
+// Non blocking connect, unix sockets either connect right away or fail
+static bool Mint_Loggo_SocketConnect(Mint_Loggo_SocketSink* sink) {
+    if (sink->fd >= 0) {
+        return true;
+    }
+
+    uint64_t now = Mint_Loggo_MonotonicMs();
+    if (now < sink->next_connect_ms) {
+        return false;
+    }
+
+    int fd = socket(AF_UNIX, sink->config.datagram ? SOCK_DGRAM : SOCK_STREAM, 0);
+    if (fd >= 0) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        #ifdef SO_NOSIGPIPE
+            int on = 1;
+            setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+        #endif
+
+        struct sockaddr_un address;
+        memset(&address, 0U, sizeof(address));
+        address.sun_family = AF_UNIX;
+        strcpy(address.sun_path, sink->path);
+
+        if (connect(fd, (struct sockaddr*)&address, sizeof(address)) == 0) {
+            sink->fd = fd;
+            sink->backoff_ms = sink->config.reconnect_ms;
+
+            // Never resume a stream in the middle of a record, resend the whole frame instead (at least once)
+            if (sink->used > 0 && sink->frames[sink->first].sent > 0) {
+                sink->frames[sink->first].sent = 0;
+            }
+            return true;
+        }
+        close(fd);
+    }
+
+    // Back off so a dead peer costs one syscall every so often
+    sink->next_connect_ms = now + sink->backoff_ms;
+    sink->backoff_ms *= 2U;
+    if (sink->backoff_ms > MINT_LOGGO_SOCKET_MAX_RECONNECT_MS) sink->backoff_ms = MINT_LOGGO_SOCKET_MAX_RECONNECT_MS;
+    return false;
+}
+
+
+static void Mint_Loggo_SocketDisconnect(Mint_Loggo_SocketSink* sink) {
+    if (sink->fd >= 0) {
+        close(sink->fd);
+        sink->fd = -1;
+    }
+    sink->next_connect_ms = Mint_Loggo_MonotonicMs() + sink->backoff_ms;
+}
+
+
+// Release the oldest frame for reuse
+static void Mint_Loggo_SocketPopFrame(Mint_Loggo_SocketSink* sink) {
+    Mint_Loggo_SocketFrame* frame = &sink->frames[sink->first];
+    frame->len = 0U;
+    frame->sent = 0U;
+    frame->records = 0U;
+    sink->first = (sink->first + 1U) % sink->frame_count;
+    sink->used--;
+}
+
+
+// Send complete frames, the open frame too if include_open
+// Blocking only waits on a connected peer, it never waits for a reconnect
+static void Mint_Loggo_SocketSend(Mint_Loggo_SocketSink* sink, bool include_open, bool blocking) {
+    while (sink->used > (include_open ? 0U : 1U)) {
+        if (!Mint_Loggo_SocketConnect(sink)) {
+            return;
+        }
+
+        Mint_Loggo_SocketFrame* frame = &sink->frames[sink->first];
+        if (frame->len == 0U) {
+            Mint_Loggo_SocketPopFrame(sink);
+            continue;
+        }
+
+        ssize_t result = send(sink->fd, frame->data + frame->sent, frame->len - frame->sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (result >= 0) {
+            // Datagrams go all at once, streams may be partial
+            frame->sent = sink->config.datagram ? frame->len : frame->sent + (uint32_t)result;
+            if (frame->sent == frame->len) {
+                Mint_Loggo_SocketPopFrame(sink);
+            }
+            continue;
+        }
+
+        if (errno == EINTR) {
+            continue;
+        }
+
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+            if (!blocking) {
+                return;
+            }
+            struct pollfd waiter = {.fd = sink->fd, .events = POLLOUT};
+            poll(&waiter, 1, (int)sink->config.reconnect_ms);
+            continue;
+        }
+
+        // Too big for a datagram, nothing will ever make it fit
+        if (errno == EMSGSIZE) {
+            sink->dropped += frame->records;
+            Mint_Loggo_SocketPopFrame(sink);
+            continue;
+        }
+
+        // Peer went away, keep the frames and try again later
+        Mint_Loggo_SocketDisconnect(sink);
+        return;
+    }
+}
+
+
+// Append a record to the open frame, opening a new frame when it doesnt fit
+MINT_LOGGO_DEF int Mint_Loggo_SocketWrite(char* text, void* arg) {
+    return Mint_Loggo_SocketWriteLen(text, strlen(text), arg);
+}
+
+
+MINT_LOGGO_DEF int Mint_Loggo_SocketWriteLen(const char* text, size_t text_len, void* arg) {
+    Mint_Loggo_IoVec part = {text, text_len};
+    return Mint_Loggo_SocketWriteVec(&part, 1, arg);
+}
+
+
+// The pieces form one record
+MINT_LOGGO_DEF int Mint_Loggo_SocketWriteVec(const Mint_Loggo_IoVec* parts, int count, void* arg) {
+    Mint_Loggo_SocketSink* sink = arg;
+    uint32_t len = 0U;
+    for (int idx = 0; idx < count; idx++) {
+        len += (uint32_t)parts[idx].len;
+    }
+    Mint_Loggo_SocketFrame* open = sink->used ? &sink->frames[(sink->first + sink->used - 1U) % sink->frame_count] : NULL;
+
+    if (!open || (open->len > 0U && open->len + len > sink->config.frame_size)) {
+        // A frame just closed, ship what we can without waiting, the new frame isnt open yet so the
+        // closed one counts as open here
+        Mint_Loggo_SocketSend(sink, true, false);
+
+        if (sink->used == sink->frame_count) {
+            bool connected = sink->fd >= 0;
+            if (sink->config.overflow == MINT_LOGGO_OVERFLOW_BLOCK && connected) {
+                Mint_Loggo_SocketSend(sink, false, true);
+            } else if (sink->config.overflow == MINT_LOGGO_OVERFLOW_DROP_OLDEST && sink->frames[sink->first].sent == 0U) {
+                sink->dropped += sink->frames[sink->first].records;
+                Mint_Loggo_SocketPopFrame(sink);
+            }
+        }
+
+        // Still no room
+        if (sink->used == sink->frame_count) {
+            sink->dropped++;
+            return -1;
+        }
+
+        open = &sink->frames[(sink->first + sink->used) % sink->frame_count];
+        sink->used++;
+    }
+
+    // Oversized records get a frame of their own
+    if (open->len + len > open->capacity) {
+        open->capacity = (open->len + len > sink->config.frame_size) ? open->len + len : sink->config.frame_size;
+        open->data = MINT_LOGGO_REALLOC(open->data, open->capacity);
+    }
+
+    for (int idx = 0; idx < count; idx++) {
+        memcpy(open->data + open->len, parts[idx].data, parts[idx].len);
+        open->len += (uint32_t)parts[idx].len;
+    }
+    open->records++;
+    return (int)len;
+}
+
+
+// Push out everything including the partially filled frame
+MINT_LOGGO_DEF int Mint_Loggo_SocketFlush(void* arg) {
+    Mint_Loggo_SocketSink* sink = arg;
+    Mint_Loggo_SocketSend(sink, true, false);
+    return sink->used ? -1 : 0;
+}
+
+
+// Last chance to send, a blocking sink waits for a connected peer
+MINT_LOGGO_DEF int Mint_Loggo_SocketClose(void* arg) {
+    Mint_Loggo_SocketSink* sink = arg;
+    Mint_Loggo_SocketSend(sink, true, sink->config.overflow == MINT_LOGGO_OVERFLOW_BLOCK);
+    int result = sink->used ? -1 : 0;
+
+    if (sink->fd >= 0) {
+        close(sink->fd);
+    }
+
+    for (uint32_t idx = 0; idx < sink->frame_count; idx++) {
+        if (sink->frames[idx].data) {
+            MINT_LOGGO_FREE(sink->frames[idx].data);
+        }
+    }
+
+    MINT_LOGGO_FREE(sink->frames);
+    MINT_LOGGO_FREE(sink->path);
+    memset(sink, 0U, sizeof(*sink));
+    MINT_LOGGO_FREE(sink);
+    return result;
+}
+
+
+MINT_LOGGO_DEF uint64_t Mint_Loggo_SocketDropped(Mint_Loggo_SocketSink* sink) {
+    return sink->dropped;
+}
 
-    // Create User handler
-    Mint_Loggo_LogFormat* log_format = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_LogFormat));
-    memset(log_format, 0U, sizeof(*log_format));
+#endif // MINT_LOGGO_HAS_SOCKETS
 
-    // Copy user format if it exists
-    if (user_format) { 
-        memcpy(log_format, user_format, sizeof(*user_format));
+
+// LZ block codec
+// A block is a run of sequences: token, literal length bytes, literals, 2 byte offset, match length bytes
+// The token holds the literal length in the high nibble and match length - 4 in the low one, 15 means more
+// length bytes follow (255 continues). The last sequence only has literals and ends the block.
+
+
+static uint32_t Mint_Loggo_LZRead32(const uint8_t* ptr) {
+    uint32_t value;
+    memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+
+static uint8_t* Mint_Loggo_LZWriteLength(uint8_t* op, size_t len) {
+    while (len >= 255U) {
+        *op++ = 255U;
+        len -= 255U;
     }
+    *op++ = (uint8_t)len;
+    return op;
+}
 
-    // Set defaults
-    // Level defaults to LOG_DEBUG
-    // colors defaults to 0 (false)
-    // flush defaults to 0 (false)
 
-    if (!log_format->linesep) log_format->linesep = MINT_LOGGO_DEFAULT_LINE_SEP;
-    if (log_format->queue_capacity == 0) log_format->queue_capacity = MINT_LOGGO_DEFAULT_QUEUE_SIZE;
-    if (!log_format->time_format) log_format->time_format = MINT_LOGGO_DEFAULT_TIME_FORMAT;
-    if (!log_format->linebeg) log_format->linebeg = MINT_LOGGO_DEFAULT_LINE_BEG;
-    return log_format;
+MINT_LOGGO_DEF size_t Mint_Loggo_LZBound(size_t len) {
+    return len + len / 255U + 16U;
 }
 
 
-static Mint_Loggo_LogHandler* Mint_Loggo_CreateLogHandler(Mint_Loggo_LogHandler* user_handler) {
+// Greedy single probe hash matcher, skips ahead faster the longer it goes without a match
+MINT_LOGGO_DEF size_t Mint_Loggo_LZCompress(const void* src, size_t len, void* dst, uint32_t* table) {
+    const uint8_t* in = src;
+    uint8_t* op = dst;
+    size_t anchor = 0U;
+    size_t ip = 0U;
 
-    // Create User handler
-    Mint_Loggo_LogHandler* log_handler = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_LogHandler));
-    memset(log_handler, 0U, sizeof(*log_handler));
+    memset(table, 0U, sizeof(uint32_t) * MINT_LOGGO_LZ_TABLE_SIZE);
 
-    // Copy user format if it exists
-    if (user_handler) { 
-        memcpy(log_handler, user_handler, sizeof(*user_handler));
+    // Keep a few bytes back so the four byte reads stay inside the block
+    size_t limit = len > 8U ? len - 8U : 0U;
+    while (ip < limit) {
+        uint32_t sequence = Mint_Loggo_LZRead32(in + ip);
+        uint32_t hash = (sequence * 2654435761U) >> 20;
+        size_t ref = table[hash];
+        table[hash] = (uint32_t)ip;
 
-        // You need the handle
-        if (!log_handler->handle) {
-            Mint_Loggo_DestroyLogHandler(log_handler);
-            return NULL;
+        if (ref >= ip || ip - ref > MINT_LOGGO_LZ_MAX_OFFSET || Mint_Loggo_LZRead32(in + ref) != sequence) {
+            ip += 1U + ((ip - anchor) >> 6);
+            continue;
         }
 
-        // Set NULL handlers if they are not there
-        if(!log_handler->write_handler) log_handler->write_handler = Mint_Loggo_NullWrite;
-        if(!log_handler->flush_handler) log_handler->flush_handler = Mint_Loggo_NullFlush;
-        if(!log_handler->close_handler) log_handler->close_handler = Mint_Loggo_NullClose;
+        // Word at a time until the first difference, then byte at a time to find it
+        size_t match = MINT_LOGGO_LZ_MIN_MATCH;
+        while (ip + match + 8U <= len && memcmp(in + ref + match, in + ip + match, 8U) == 0) {
+            match += 8U;
+        }
+        while (ip + match < len && in[ref + match] == in[ip + match]) {
+            match++;
+        }
 
-    } else {
-        // Defaults
-        log_handler->handle = stdout;
-        log_handler->write_handler = Mint_Loggo_StreamWrite;
-        log_handler->close_handler = Mint_Loggo_StreamClose;
-        log_handler->flush_handler = Mint_Loggo_StreamFlush;
+        size_t literals = ip - anchor;
+        size_t extra = match - MINT_LOGGO_LZ_MIN_MATCH;
+        uint8_t* token = op++;
+        *token = (uint8_t)(((literals < 15U ? literals : 15U) << 4) | (extra < 15U ? extra : 15U));
+        if (literals >= 15U) op = Mint_Loggo_LZWriteLength(op, literals - 15U);
+        memcpy(op, in + anchor, literals);
+        op += literals;
+
+        size_t offset = ip - ref;
+        *op++ = (uint8_t)(offset & 0xFFU);
+        *op++ = (uint8_t)(offset >> 8);
+        if (extra >= 15U) op = Mint_Loggo_LZWriteLength(op, extra - 15U);
+
+        ip += match;
+        anchor = ip;
     }
 
-    return log_handler;  
+    // Whatever is left goes out as literals
+    size_t literals = len - anchor;
+    *op++ = (uint8_t)((literals < 15U ? literals : 15U) << 4);
+    if (literals >= 15U) op = Mint_Loggo_LZWriteLength(op, literals - 15U);
+    memcpy(op, in + anchor, literals);
+    op += literals;
+    return (size_t)(op - (uint8_t*)dst);
 }
 
 
-static void Mint_Loggo_DestroyLogHandler(Mint_Loggo_LogHandler* handler) {
-    #ifdef MINT__DEBUG
-        assert(handler);
-    #endif
+// Every length and offset is checked so a torn or corrupt block fails instead of overrunning dst
+MINT_LOGGO_DEF size_t Mint_Loggo_LZDecompress(const void* src, size_t len, void* dst, size_t capacity) {
+    const uint8_t* in = src;
+    uint8_t* out = dst;
+    size_t ip = 0U;
+    size_t op = 0U;
 
-    memset(handler, 0U, sizeof(*handler));
-    MINT_LOGGO_FREE(handler);  
-}
+    while (ip < len) {
+        uint8_t token = in[ip++];
 
+        size_t literals = token >> 4;
+        if (literals == 15U) {
+            uint8_t more = 255U;
+            while (more == 255U && ip < len) {
+                more = in[ip++];
+                literals += more;
+            }
+        }
+        if (literals > len - ip || literals > capacity - op) {
+            return SIZE_MAX;
+        }
+        memcpy(out + op, in + ip, literals);
+        ip += literals;
+        op += literals;
 
-static void Mint_Loggo_DestroyLogFormat(Mint_Loggo_LogFormat* format) {
-    #ifdef MINT__DEBUG
-        assert(format);
-    #endif
+        // Last sequence
+        if (ip == len) {
+            break;
+        }
 
-    memset(format, 0U, sizeof(*format));
-    MINT_LOGGO_FREE(format);
+        if (len - ip < 2U) {
+            return SIZE_MAX;
+        }
+        size_t offset = (size_t)in[ip] | ((size_t)in[ip + 1U] << 8);
+        ip += 2U;
+
+        size_t match = (token & 15U);
+        if (match == 15U) {
+            uint8_t more = 255U;
+            while (more == 255U && ip < len) {
+                more = in[ip++];
+                match += more;
+            }
+        }
+        match += MINT_LOGGO_LZ_MIN_MATCH;
+        if (offset == 0U || offset > op || match > capacity - op) {
+            return SIZE_MAX;
+        }
+
+        // Matches may overlap what they produce, 8 byte steps are safe once the source is that far back
+        size_t end = op + match;
+        if (offset >= 8U) {
+            for (; op + 8U <= end; op += 8U) {
+                memcpy(out + op, out + op - offset, 8U);
+            }
+        }
+        for (; op < end; op++) {
+            out[op] = out[op - offset];
+        }
+    }
+    return op;
 }
 
 
-// Actual ouptut of message and cleanup
-static void Mint_Loggo_HandleLogMessage(Mint_Loggo_LogMessage* message, Mint_Loggo_LogFormat* format, Mint_Loggo_LogHandler* handler) {
-    #ifdef MINT__DEBUG
-        assert(message);
-        assert(format);
-        assert(handler);
-    #endif
+// File sink
+
+
+// Open the log and its index, appending keeps counting from the current end of the log
+MINT_LOGGO_DEF Mint_Loggo_FileSink* Mint_Loggo_FileOpen(const Mint_Loggo_FileConfig* config) {
+    if (!config || !config->path) {
+        return NULL;
+    }
+
+    FILE* file = fopen(config->path, config->append ? "ab" : "wb");
+    if (!file) {
+        return NULL;
+    }
+
+    Mint_Loggo_FileSink* sink = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_FileSink));
+    memset(sink, 0U, sizeof(*sink));
+    memcpy(&sink->config, config, sizeof(*config));
+    sink->file = file;
 
-    if (message->level >= format->level) {
-        if (format->colors) {
-            handler->write_handler(Mint_Loggo_ColorFromLevel(message->level), handler->handle);
+    if (sink->config.index_records == 0) sink->config.index_records = MINT_LOGGO_DEFAULT_INDEX_RECORDS;
+    if (sink->config.index_bytes == 0) sink->config.index_bytes = MINT_LOGGO_DEFAULT_INDEX_BYTES;
+    if (sink->config.block_size == 0) sink->config.block_size = MINT_LOGGO_DEFAULT_BLOCK_SIZE;
+
+    if (sink->config.compression == MINT_LOGGO_COMPRESSION_LZ) {
+        sink->table = MINT_LOGGO_MALLOC(sizeof(uint32_t) * MINT_LOGGO_LZ_TABLE_SIZE);
+    }
+
+    // Paths are only needed while opening, unless a forked child has to derive its own from them
+    sink->config.path = NULL;
+    sink->config.index_path = NULL;
+    sink->pid = MINT_LOGGO_GET_PID();
+    if (config->per_process) {
+        Mint_Loggo_MakePiece(&sink->path, config->path, "", "");
+        if (config->index_path) {
+            Mint_Loggo_MakePiece(&sink->index_path, config->index_path, "", "");
         }
+    }
 
-        // Write actual output
-        handler->write_handler(format->linebeg, handler->handle);
-        handler->write_handler(" ", handler->handle);
-        handler->write_handler(message->msg, handler->handle);
-        handler->write_handler(format->linesep, handler->handle);
+    if (config->append) {
+        fseek(file, 0, SEEK_END);
+        #if defined(_WIN32)
+            sink->offset = (uint64_t)_ftelli64(file);
+        #else
+            sink->offset = (uint64_t)ftello(file);
+        #endif
+    }
 
-        // Reset colors
-        if (format->colors) {
-            handler->write_handler(MINT_LOGGO_RESET, handler->handle);
+    if (!config->no_index) {
+        char* index_path = NULL;
+        if (config->index_path) {
+            Mint_Loggo_MakePiece(&index_path, config->index_path, "", "");
+        } else {
+            Mint_Loggo_MakePiece(&index_path, config->path, ".idx", "");
         }
+        sink->index = fopen(index_path, config->append ? "ab" : "wb");
+        MINT_LOGGO_FREE(index_path);
 
-        // Flush if needed
-        if (format->flush) {
-            handler->flush_handler(handler->handle);
+        if (!sink->index) {
+            fclose(file);
+            if (sink->table) {
+                MINT_LOGGO_FREE(sink->table);
+            }
+            MINT_LOGGO_FREE(sink);
+            return NULL;
+        }
+
+        // A fresh index starts with the magic, appends go after whatever is there
+        fseek(sink->index, 0, SEEK_END);
+        if (ftell(sink->index) == 0) {
+            fwrite(MINT_LOGGO_INDEX_MAGIC, 1U, strlen(MINT_LOGGO_INDEX_MAGIC), sink->index);
+        } else if (config->append) {
+            Mint_Loggo_FileCoverGap(sink, config);
         }
     }
+    return sink;
+}
 
-    // Clean up message
-    MINT_LOGGO_FREE(message->msg);
-    message->msg = NULL;
 
-    // Clean up message
-    MINT_LOGGO_FREE(message);
+MINT_LOGGO_DEF int Mint_Loggo_FileWrite(char* text, void* arg) {
+    return Mint_Loggo_FileWriteLen(text, strlen(text), arg);
 }
 
 
-// Thread spawned handler of messages
-static void* Mint_Loggo_RunLogger(void* arg) {
-    #ifdef MINT__DEBUG
-        assert(arg);
-    #endif
-    Mint_Loggo_Logger* logger = arg;
-    #ifdef MINT__DEBUG
-        assert(logger->queue);
-    #endif
+MINT_LOGGO_DEF int Mint_Loggo_FileWriteLen(const char* text, size_t len, void* arg) {
+    Mint_Loggo_FileSink* sink = arg;
+    if (sink->table) {
+        Mint_Loggo_FileAppendBlock(sink, text, len);
+        return (int)len;
+    }
 
-    // For some reason you have to grab the read lock and read all that you can in a loop
-    // Or else the condition is never signaled and you wait
-    while (!logger->done) {
-        Mint_Loggo_LogMessage* message = Mint_Loggo_Dequeue(logger->queue);
+    size_t written = fwrite(text, 1U, len, sink->file);
+    sink->offset += written;
+    return (int)written;
+}
 
-        #ifdef MINT__DEBUG
-            assert(logger);
-            assert(message);
-        #endif
 
-        if (message) {
-            // Done at this point
-            if (message->done) {
-                logger->done = true;
-                continue;
-            }
+MINT_LOGGO_DEF int Mint_Loggo_FileWriteVec(const Mint_Loggo_IoVec* parts, int count, void* arg) {
+    Mint_Loggo_FileSink* sink = arg;
+    size_t written = 0U;
+    for (int idx = 0; idx < count; idx++) {
+        if (sink->table) {
+            Mint_Loggo_FileAppendBlock(sink, parts[idx].data, parts[idx].len);
+            written += parts[idx].len;
+        } else {
+            written += fwrite(parts[idx].data, 1U, parts[idx].len, sink->file);
+        }
+    }
+    if (!sink->table) {
+        sink->offset += written;
+    }
+    return (int)written;
+}
 
-            // Log the messages, then free them
-            Mint_Loggo_HandleLogMessage(message, logger->format, logger->handler);
+
+// Without an index there are no record boundaries to wait for so full blocks go out right away
+static void Mint_Loggo_FileAppendBlock(Mint_Loggo_FileSink* sink, const char* text, size_t len) {
+    Mint_Loggo_ReserveBuffer(&sink->block, &sink->block_capacity, sink->block_len + len);
+    memcpy(sink->block + sink->block_len, text, len);
+    sink->block_len += len;
+
+    if (!sink->index && sink->block_len >= sink->config.block_size) {
+        Mint_Loggo_FileEmitFrame(sink);
+    }
+}
+
+
+// Compress the block and write it as one frame, blocks that dont shrink are stored
+static void Mint_Loggo_FileEmitFrame(Mint_Loggo_FileSink* sink) {
+    if (sink->block_len == 0U) {
+        return;
+    }
+
+    Mint_Loggo_ReserveBuffer(&sink->packed, &sink->packed_capacity, Mint_Loggo_LZBound(sink->block_len));
+    size_t packed = Mint_Loggo_LZCompress(sink->block, sink->block_len, sink->packed, sink->table);
+
+    Mint_Loggo_FrameHeader header = {.magic = MINT_LOGGO_FRAME_MAGIC, .raw_len = (uint32_t)sink->block_len};
+    const char* payload = sink->packed;
+    if (packed >= sink->block_len) {
+        header.flags = MINT_LOGGO_FRAME_STORED;
+        payload = sink->block;
+        packed = sink->block_len;
+    }
+    header.stored_len = (uint32_t)packed;
+
+    fwrite(&header, sizeof(header), 1U, sink->file);
+    fwrite(payload, 1U, packed, sink->file);
+    sink->offset += sizeof(header) + packed;
+    sink->block_len = 0U;
+}
+
+
+// Called before the record is written so a full chunk ends right where the new record starts
+MINT_LOGGO_DEF void Mint_Loggo_FileRecord(Mint_Loggo_LogLevel level, uint64_t nanos, void* arg) {
+    Mint_Loggo_FileSink* sink = arg;
+    Mint_Loggo_IndexEntry* chunk = &sink->chunk;
+    if (!sink->index) {
+        return;
+    }
+
+    // Compressed chunks are exactly one frame so the query tool can decode them on their own
+    bool full = sink->table ? sink->block_len >= sink->config.block_size : sink->offset - chunk->offset >= sink->config.index_bytes;
+    if (chunk->records && (chunk->records >= sink->config.index_records || full)) {
+        if (sink->table) {
+            Mint_Loggo_FileEmitFrame(sink);
         }
+        Mint_Loggo_FileCloseChunk(sink);
     }
 
-    return EXIT_SUCCESS;
+    // Urgent lanes and clock adjustments can reorder stamps a little so keep a range
+    if (chunk->records == 0) {
+        chunk->offset = sink->offset;
+        chunk->first_ns = nanos;
+        chunk->last_ns = nanos;
+    } else if (nanos < chunk->first_ns) {
+        chunk->first_ns = nanos;
+    } else if (nanos > chunk->last_ns) {
+        chunk->last_ns = nanos;
+    }
+
+    int32_t slot = (level >= MINT_LOGGO_LEVEL_DEBUG && level <= MINT_LOGGO_LEVEL_FATAL) ? (int32_t)level : MINT_LOGGO_LEVEL_FATAL + 1;
+    chunk->counts[slot]++;
+    chunk->records++;
 }
 
 
-// Create a nice formatted log message
-static Mint_Loggo_LogMessage* Mint_Loggo_CreateLogMessage(Mint_Loggo_Logger* logger, Mint_Loggo_LogLevel level, const char* msg) {
-    // Misc
-    char* formatted_msg = NULL;
-    uint32_t padding = 3U + 2U;
+// A writer that never closed its sink leaves bytes behind its last entry, cover them with an
+// entry that matches every query so they are not lost between this run's chunks
+static void Mint_Loggo_FileCoverGap(Mint_Loggo_FileSink* sink, const Mint_Loggo_FileConfig* config) {
+    uint64_t indexed_end = 0U;
+    Mint_Loggo_IndexEntry last;
+    FILE* index = config->index_path ? fopen(config->index_path, "rb") : NULL;
+    if (!config->index_path) {
+        char* index_path = NULL;
+        Mint_Loggo_MakePiece(&index_path, config->path, ".idx", "");
+        index = fopen(index_path, "rb");
+        MINT_LOGGO_FREE(index_path);
+    }
 
-    // Level String
-    const char* level_string = Mint_Loggo_StringFromLevel(level);
-    uint32_t level_size = strlen(level_string);
+    if (!index) {
+        return;
+    }
+    if (fseek(index, -(long)sizeof(last), SEEK_END) == 0 && fread(&last, sizeof(last), 1U, index) == 1U) {
+        indexed_end = last.offset + last.length;
+    }
+    fclose(index);
 
-    // Get time
-    char time_buffer[128U];
-    time_t current_time = time(NULL);
-    time_buffer[strftime(time_buffer, sizeof(time_buffer), logger->format->time_format, localtime(&current_time))] = '\0';
+    if (sink->offset > indexed_end) {
+        Mint_Loggo_IndexEntry gap = {.offset = indexed_end, .length = sink->offset - indexed_end, .first_ns = 0U, .last_ns = UINT64_MAX, .records = 1U};
+        gap.counts[MINT_LOGGO_LEVEL_FATAL + 1] = 1U;
+        fwrite(&gap, sizeof(gap), 1U, sink->index);
+    }
+}
 
-    // Create LogMessage
-    Mint_Loggo_LogMessage* message = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_LogMessage));
-    memset(message, 0U, sizeof(*message));
-    
-    // Insert formatted message inside of LogMessage
-    formatted_msg = MINT_LOGGO_MALLOC(strlen(msg) + strlen(time_buffer) + level_size + padding + 1U);
-    sprintf(formatted_msg, "[%s] %s %s", time_buffer, level_string, msg);
-    message->level = level;
-    message->msg = formatted_msg;
 
-    return message;
+// Forked child of a per process sink, whatever is buffered belongs to the parent and is thrown away
+// Nothing the child could report to, a file that wont open leaves writes going nowhere
+static void Mint_Loggo_FileReopen(Mint_Loggo_FileSink* sink) {
+    char pid[32U];
+    snprintf(pid, sizeof(pid), ".%llu", (unsigned long long)MINT_LOGGO_GET_PID());
+
+    // Closing the descriptor first makes fclose drop the buffer instead of writing it again
+    #if defined(MINT_LOGGO_HAS_FORK)
+        close(fileno(sink->file));
+        if (sink->index) {
+            close(fileno(sink->index));
+        }
+    #endif
+    fclose(sink->file);
+    if (sink->index) {
+        fclose(sink->index);
+        sink->index = NULL;
+    }
+
+    char* path = NULL;
+    Mint_Loggo_MakePiece(&path, sink->path, pid, "");
+    sink->file = fopen(path, "wb");
+    if (!sink->file) {
+        sink->file = fopen("/dev/null", "wb");
+    }
+
+    if (!sink->config.no_index) {
+        char* index_path = NULL;
+        if (sink->index_path) {
+            Mint_Loggo_MakePiece(&index_path, sink->index_path, pid, "");
+        } else {
+            Mint_Loggo_MakePiece(&index_path, path, ".idx", "");
+        }
+        sink->index = fopen(index_path, "wb");
+        if (sink->index) {
+            fwrite(MINT_LOGGO_INDEX_MAGIC, 1U, strlen(MINT_LOGGO_INDEX_MAGIC), sink->index);
+        }
+        MINT_LOGGO_FREE(index_path);
+    }
+    MINT_LOGGO_FREE(path);
+
+    sink->offset = 0U;
+    sink->block_len = 0U;
+    memset(&sink->chunk, 0U, sizeof(sink->chunk));
+    sink->pid = MINT_LOGGO_GET_PID();
 }
 
 
-// Free all the handles
-static void Mint_Loggo_CleanUpLogger(Mint_Loggo_Logger* logger) {
+// Append the open chunk to the index and start over
+static void Mint_Loggo_FileCloseChunk(Mint_Loggo_FileSink* sink) {
+    sink->chunk.length = sink->offset - sink->chunk.offset;
+    fwrite(&sink->chunk, sizeof(sink->chunk), 1U, sink->index);
+    memset(&sink->chunk, 0U, sizeof(sink->chunk));
+}
 
-    // Queue up final message and wait for logger to close
-    Mint_Loggo_Enqueue(logger->queue, &MINT_LOGGO_LOGGER_TERMINATE);
-    MINT_LOGGO_THREAD_JOIN(logger->thread_id);
 
-    // Free handles
-    Mint_Loggo_DestroyLogHandler(logger->handler);
-    logger->handler = NULL;
+// The index is flushed after the log so an entry never points past what is on disk
+// A compressed sink keeps the block it is filling, flushing it would make every batch its own frame
+MINT_LOGGO_DEF int Mint_Loggo_FileFlush(void* arg) {
+    Mint_Loggo_FileSink* sink = arg;
+    int result = fflush(sink->file);
+    if (sink->index) {
+        fflush(sink->index);
+    }
+    return result;
+}
 
-    Mint_Loggo_DestroyLogFormat(logger->format);
-    logger->format = NULL;
 
-    Mint_Loggo_DestroyQueue(logger->queue);
-    logger->queue = NULL;
+// The open chunk also covers anything written after its last record
+MINT_LOGGO_DEF int Mint_Loggo_FileClose(void* arg) {
+    Mint_Loggo_FileSink* sink = arg;
+    if (sink->table) {
+        Mint_Loggo_FileEmitFrame(sink);
+        MINT_LOGGO_FREE(sink->table);
+    }
+    if (sink->block) {
+        MINT_LOGGO_FREE(sink->block);
+    }
+    if (sink->packed) {
+        MINT_LOGGO_FREE(sink->packed);
+    }
+    if (sink->path) {
+        MINT_LOGGO_FREE(sink->path);
+    }
+    if (sink->index_path) {
+        MINT_LOGGO_FREE(sink->index_path);
+    }
+    int result = fclose(sink->file);
+
+    if (sink->index) {
+        if (sink->chunk.records) {
+            Mint_Loggo_FileCloseChunk(sink);
+        }
+        fclose(sink->index);
+    }
 
-    MINT_LOGGO_FREE(logger);
+    memset(sink, 0U, sizeof(*sink));
+    MINT_LOGGO_FREE(sink);
+    return result;
 }
 
 
@@ -983,128 +5383,295 @@ static void Mint_Loggo_CleanUpLogger(Mint_Loggo_Logger* logger) {
 
 
 // Try to find an item returning NULL if not found
+// Lock free, a miss while a rehash was publishing is looked up again in the new table
+// Readers count themselves in under the current epoch, HTSynchronize waits for the old one to empty
 static Mint_Loggo_Logger* Mint_Loggo_HTFindItem(const char* name) {
-    int32_t hash = Mint_Loggo_LoggerStringHash(name, MINT_LOGGO_LOGGER_HASH_TABLE.capacity, 0);
-    int32_t attempt = 1;
-    Mint_Loggo_Logger* current_logger = MINT_LOGGO_LOGGER_HASH_TABLE.loggers[hash];
-    while(current_logger != NULL) {
-        if (current_logger != &MINT_LOGGO_LOGGER_DELETED) {
-            if (strcmp(name, current_logger->name) == 0) {
-                return current_logger;
+    Mint_Loggo_HashTable* table = &MINT_LOGGO_LOGGER_HASH_TABLE;
+    uint32_t epoch = MINT_LOGGO_ATOMIC_LOAD(&MINT_LOGGO_LOOKUP_EPOCH);
+    MINT_LOGGO_ATOMIC_ADD(&MINT_LOGGO_LOOKUP_READERS[epoch & 1U], 1U);
+    while (MINT_LOGGO_ATOMIC_LOAD(&MINT_LOGGO_LOOKUP_EPOCH) != epoch) {
+        MINT_LOGGO_ATOMIC_ADD(&MINT_LOGGO_LOOKUP_READERS[epoch & 1U], -1);
+        epoch = MINT_LOGGO_ATOMIC_LOAD(&MINT_LOGGO_LOOKUP_EPOCH);
+        MINT_LOGGO_ATOMIC_ADD(&MINT_LOGGO_LOOKUP_READERS[epoch & 1U], 1U);
+    }
+
+    Mint_Loggo_Logger* found = NULL;
+    for (;;) {
+        uint32_t generation = MINT_LOGGO_ATOMIC_LOAD(&table->generation);
+        if (generation & 1U) {
+            MINT_LOGGO_THREAD_YIELD();
+            continue;
+        }
+
+        // Capacity first, a new capacity is only stored once its table is
+        int32_t capacity = MINT_LOGGO_ATOMIC_LOAD(&table->capacity);
+        Mint_Loggo_Logger** loggers = MINT_LOGGO_ATOMIC_LOAD(&table->loggers);
+        if (loggers && capacity > 0) {
+            uint32_t start = 0U;
+            uint32_t step = 0U;
+            Mint_Loggo_HTProbe(name, capacity, &start, &step);
+            for (int32_t attempt = 0; attempt < capacity; attempt++) {
+                Mint_Loggo_Logger* current_logger = MINT_LOGGO_ATOMIC_LOAD(&loggers[(start + (uint32_t)attempt * step) % (uint32_t)capacity]);
+                if (!current_logger) {
+                    break;
+                }
+                if (current_logger != &MINT_LOGGO_LOGGER_DELETED && strcmp(name, current_logger->name) == 0) {
+                    found = current_logger;
+                    break;
+                }
             }
         }
-        hash = Mint_Loggo_LoggerStringHash(name, MINT_LOGGO_LOGGER_HASH_TABLE.capacity, attempt);
-        current_logger = MINT_LOGGO_LOGGER_HASH_TABLE.loggers[hash];
-        attempt++;
+
+        if (found || MINT_LOGGO_ATOMIC_LOAD(&table->generation) == generation) {
+            break;
+        }
     }
 
-    return NULL;
+    MINT_LOGGO_ATOMIC_ADD(&MINT_LOGGO_LOOKUP_READERS[epoch & 1U], -1);
+    return found;
 }
 
 
-// Try to insert an item, resize if needed
-static int32_t Mint_Loggo_HTInsertItem(const char* name, Mint_Loggo_Logger* logger) {
-    // Try a resize
+// Try to insert an item, resize if needed, an existing logger with the name is replaced
+// The whole chain is searched for the name before the first free slot (or tombstone) is taken
+// A replaced logger comes back through replaced for the caller to clean up once the lock is released
+static int32_t Mint_Loggo_HTInsertItem(const char* name, Mint_Loggo_Logger* logger, Mint_Loggo_Logger** replaced) {
     Mint_Loggo_HTResizeTable();
-    int32_t hash = Mint_Loggo_LoggerStringHash(name, MINT_LOGGO_LOGGER_HASH_TABLE.capacity, 0);
-    int32_t attempt = 1;
-    Mint_Loggo_Logger* current_logger = MINT_LOGGO_LOGGER_HASH_TABLE.loggers[hash];
-    while(current_logger != NULL && current_logger != &MINT_LOGGO_LOGGER_DELETED) {
-        hash = Mint_Loggo_LoggerStringHash(name, MINT_LOGGO_LOGGER_HASH_TABLE.capacity, attempt);
-        current_logger = MINT_LOGGO_LOGGER_HASH_TABLE.loggers[hash];
-        // If the item exists update it
-        if (current_logger) {
-            if (strcmp(name, current_logger->name) == 0) {
-                Mint_Loggo_CleanUpLogger(current_logger);
-                MINT_LOGGO_LOGGER_HASH_TABLE.loggers[hash] = logger;
-                return logger->id;
-            }
+    Mint_Loggo_HashTable* table = &MINT_LOGGO_LOGGER_HASH_TABLE;
+    uint32_t start = 0U;
+    uint32_t step = 0U;
+    Mint_Loggo_HTProbe(name, table->capacity, &start, &step);
+
+    int32_t free_slot = -1;
+    for (int32_t attempt = 0; attempt < table->capacity; attempt++) {
+        int32_t hash = (int32_t)((start + (uint32_t)attempt * step) % (uint32_t)table->capacity);
+        Mint_Loggo_Logger* current_logger = table->loggers[hash];
+        if (!current_logger) {
+            free_slot = free_slot == -1 ? hash : free_slot;
+            break;
+        }
+        if (current_logger == &MINT_LOGGO_LOGGER_DELETED) {
+            free_slot = free_slot == -1 ? hash : free_slot;
+            continue;
         }
 
-        attempt++;
+        // If the item exists update it, a child going with its owner cant be replaced until it is gone
+        if (strcmp(name, current_logger->name) == 0) {
+            if (current_logger->owner && current_logger->owner->unlinked) {
+                return -1;
+            }
+            logger->id = hash;
+            MINT_LOGGO_ATOMIC_STORE(&table->loggers[hash], logger);
+            *replaced = Mint_Loggo_UnlinkLogger(current_logger);
+            return logger->id;
+        }
+    }
 
+    if (free_slot == -1) {
+        return -1;
     }
 
-    MINT_LOGGO_LOGGER_HASH_TABLE.loggers[hash] = logger;
-    MINT_LOGGO_LOGGER_HASH_TABLE.size++;
-    logger->id = hash;
+    if (table->loggers[free_slot] == &MINT_LOGGO_LOGGER_DELETED) {
+        table->deleted--;
+    }
+    logger->id = free_slot;
+    MINT_LOGGO_ATOMIC_STORE(&table->loggers[free_slot], logger);
+    table->size++;
     return logger->id;
 }
 
 
-static void Mint_Loggo_HTDeleteItem( const char* name) {
-    int32_t hash = Mint_Loggo_LoggerStringHash(name, MINT_LOGGO_LOGGER_HASH_TABLE.capacity, 0);
-    Mint_Loggo_Logger* current_logger = MINT_LOGGO_LOGGER_HASH_TABLE.loggers[hash];
-    int32_t attempt = 1;
-    while(current_logger != NULL) {
-        if (current_logger != &MINT_LOGGO_LOGGER_DELETED && current_logger != NULL) {
-            if (strcmp(current_logger->name, name) == 0) {
-                Mint_Loggo_CleanUpLogger(current_logger);
-                MINT_LOGGO_LOGGER_HASH_TABLE.loggers[hash] = &MINT_LOGGO_LOGGER_DELETED;
+// Unlinked before it is cleaned up so lookups stop finding it as early as possible
+// Returns the logger still to be cleaned up, a child whose owner is on its way out is left to go with it
+static Mint_Loggo_Logger* Mint_Loggo_HTDeleteItem(const char* name) {
+    Mint_Loggo_HashTable* table = &MINT_LOGGO_LOGGER_HASH_TABLE;
+    uint32_t start = 0U;
+    uint32_t step = 0U;
+    Mint_Loggo_HTProbe(name, table->capacity, &start, &step);
+
+    for (int32_t attempt = 0; attempt < table->capacity; attempt++) {
+        int32_t hash = (int32_t)((start + (uint32_t)attempt * step) % (uint32_t)table->capacity);
+        Mint_Loggo_Logger* current_logger = table->loggers[hash];
+        if (!current_logger) {
+            return NULL;
+        }
+
+        if (current_logger != &MINT_LOGGO_LOGGER_DELETED && strcmp(current_logger->name, name) == 0) {
+            if (current_logger->owner && current_logger->owner->unlinked) {
+                return NULL;
             }
+            MINT_LOGGO_ATOMIC_STORE(&table->loggers[hash], &MINT_LOGGO_LOGGER_DELETED);
+            table->size--;
+            table->deleted++;
+            return Mint_Loggo_UnlinkLogger(current_logger);
         }
-        hash = Mint_Loggo_LoggerStringHash(name, MINT_LOGGO_LOGGER_HASH_TABLE.capacity, attempt);
-        current_logger =  MINT_LOGGO_LOGGER_HASH_TABLE.loggers[hash];
-        attempt++;
     }
-    MINT_LOGGO_LOGGER_HASH_TABLE.size--; 
+    return NULL;
 }
 
 
-// Just realloc space up
+// Grow when the live loggers need it, otherwise just clear out the tombstones
 static void Mint_Loggo_HTResizeTable() {
-    int32_t load = (MINT_LOGGO_LOGGER_HASH_TABLE.size * 100) / MINT_LOGGO_LOGGER_HASH_TABLE.capacity;
-    if (load > (MINT_LOGGO_LOGGER_HASH_TABLE.load_factor * 100)) {
-        MINT_LOGGO_LOGGER_HASH_TABLE.capacity *= 2;
+    Mint_Loggo_HashTable* table = &MINT_LOGGO_LOGGER_HASH_TABLE;
+    int32_t threshold = (int32_t)(table->load_factor * 100);
+    int32_t load = ((table->size + table->deleted + 1) * 100) / table->capacity;
+    if (load <= threshold) {
+        return;
+    }
+
+    int32_t capacity = table->capacity;
+    if (((table->size + 1) * 100) / capacity > threshold / 2) {
+        capacity *= 2;
+    }
+    Mint_Loggo_HTRehash(capacity);
+}
 
-        // No need to realloc a new table
-        // Just realloc memory chunk
-        MINT_LOGGO_LOGGER_HASH_TABLE.loggers = MINT_LOGGO_REALLOC(MINT_LOGGO_LOGGER_HASH_TABLE.loggers, sizeof(Mint_Loggo_Logger*) * MINT_LOGGO_LOGGER_HASH_TABLE.capacity);
+
+// Every live logger goes into a fresh table which is then swapped in, the old one is retired
+// for the readers still on it
+static void Mint_Loggo_HTRehash(int32_t capacity) {
+    Mint_Loggo_HashTable* table = &MINT_LOGGO_LOGGER_HASH_TABLE;
+    Mint_Loggo_Logger** loggers = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_Logger*) * capacity);
+    memset(loggers, 0U, sizeof(Mint_Loggo_Logger*) * capacity);
+
+    for (int32_t idx = 0; idx < table->capacity; idx++) {
+        Mint_Loggo_Logger* logger = table->loggers[idx];
+        if (!logger || logger == &MINT_LOGGO_LOGGER_DELETED) {
+            continue;
+        }
+
+        uint32_t start = 0U;
+        uint32_t step = 0U;
+        Mint_Loggo_HTProbe(logger->name, capacity, &start, &step);
+        uint32_t hash = start;
+        for (uint32_t attempt = 1U; loggers[hash]; attempt++) {
+            hash = (start + attempt * step) % (uint32_t)capacity;
+        }
+        loggers[hash] = logger;
+        logger->id = (int32_t)hash;
+    }
+
+    Mint_Loggo_Logger** old = table->loggers;
+    MINT_LOGGO_ATOMIC_STORE(&table->generation, table->generation + 1U);
+    MINT_LOGGO_ATOMIC_STORE(&table->loggers, loggers);
+    MINT_LOGGO_ATOMIC_STORE(&table->capacity, capacity);
+    MINT_LOGGO_ATOMIC_STORE(&table->generation, table->generation + 1U);
+    table->deleted = 0;
+    Mint_Loggo_HTRetire(old);
+}
+
+
+// Loggers and tables leave through here, they are batched so a reclaim is one wait for the readers
+static void Mint_Loggo_HTRetire(void* memory) {
+    Mint_Loggo_Retired* retired = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_Retired));
+    retired->memory = memory;
+    retired->next = MINT_LOGGO_LOGGER_HASH_TABLE.retired;
+    MINT_LOGGO_LOGGER_HASH_TABLE.retired = retired;
+    MINT_LOGGO_LOGGER_HASH_TABLE.retired_count++;
+
+    if (MINT_LOGGO_LOGGER_HASH_TABLE.retired_count >= MINT_LOGGO_HT_RETIRED_MAX) {
+        Mint_Loggo_HTReclaim();
+    }
+}
+
+
+// Everything on the list is already unreachable, so once the lookups that started before now are
+// done nothing can be holding it
+static void Mint_Loggo_HTReclaim() {
+    Mint_Loggo_HTSynchronize();
+    Mint_Loggo_Retired* retired = MINT_LOGGO_LOGGER_HASH_TABLE.retired;
+    while (retired) {
+        Mint_Loggo_Retired* next = retired->next;
+        MINT_LOGGO_FREE(retired->memory);
+        MINT_LOGGO_FREE(retired);
+        retired = next;
+    }
+    MINT_LOGGO_LOGGER_HASH_TABLE.retired = NULL;
+    MINT_LOGGO_LOGGER_HASH_TABLE.retired_count = 0;
+}
+
+
+// Move new lookups to the other epoch and wait for the old one to empty, lookups never block so
+// this is short, only the registry lock holder calls it
+static void Mint_Loggo_HTSynchronize() {
+    uint32_t epoch = MINT_LOGGO_ATOMIC_ADD(&MINT_LOGGO_LOOKUP_EPOCH, 1U) - 1U;
+    while (MINT_LOGGO_ATOMIC_LOAD(&MINT_LOGGO_LOOKUP_READERS[epoch & 1U])) {
+        MINT_LOGGO_THREAD_YIELD();
     }
 }
 
 
 // Delete table and set defaults
 static void Mint_Loggo_HTDeleteTable() {
-    if (MINT_LOGGO_LOGGER_HASH_TABLE.loggers) {
-        MINT_LOGGO_FREE(MINT_LOGGO_LOGGER_HASH_TABLE.loggers);
-        MINT_LOGGO_LOGGER_HASH_TABLE.loggers = NULL;
+    Mint_Loggo_Logger** loggers = MINT_LOGGO_LOGGER_HASH_TABLE.loggers;
+    if (loggers) {
+        MINT_LOGGO_ATOMIC_STORE(&MINT_LOGGO_LOGGER_HASH_TABLE.loggers, NULL);
+        Mint_Loggo_HTRetire(loggers);
     }
+    Mint_Loggo_HTReclaim();
 
     MINT_LOGGO_LOGGER_HASH_TABLE.capacity = MINT_LOGGO_DEFAULT_HT_INITIAL_CAPACITY;
     MINT_LOGGO_LOGGER_HASH_TABLE.size = 0;
+    MINT_LOGGO_LOGGER_HASH_TABLE.deleted = 0;
     MINT_LOGGO_LOGGER_HASH_TABLE.load_factor = MINT_LOGGO_DEFAULT_HT_INITIAL_LOAD_FACTOR;
 }
 
 
+// Size the table so count loggers fit under the load factor without growing one at a time
+static void Mint_Loggo_HTReserve(int32_t count) {
+    int32_t capacity = MINT_LOGGO_LOGGER_HASH_TABLE.capacity;
+    while (count * 100 > capacity * (int32_t)(MINT_LOGGO_LOGGER_HASH_TABLE.load_factor * 100)) {
+        capacity *= 2;
+    }
+
+    if (capacity != MINT_LOGGO_LOGGER_HASH_TABLE.capacity) {
+        Mint_Loggo_HTRehash(capacity);
+    }
+}
+
+
 // Init whats needed
 static void Mint_Loggo_HTInitTable() {
     if (!MINT_LOGGO_LOGGER_HASH_TABLE.loggers) {
         MINT_LOGGO_LOGGER_HASH_TABLE.capacity = MINT_LOGGO_DEFAULT_HT_INITIAL_CAPACITY;
         MINT_LOGGO_LOGGER_HASH_TABLE.size = 0;
         MINT_LOGGO_LOGGER_HASH_TABLE.load_factor = MINT_LOGGO_DEFAULT_HT_INITIAL_LOAD_FACTOR;
-        MINT_LOGGO_LOGGER_HASH_TABLE.loggers = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_Logger*) * MINT_LOGGO_LOGGER_HASH_TABLE.capacity);
+        Mint_Loggo_Logger** loggers = MINT_LOGGO_MALLOC(sizeof(Mint_Loggo_Logger*) * MINT_LOGGO_LOGGER_HASH_TABLE.capacity);
+        memset(loggers, 0U, sizeof(Mint_Loggo_Logger*) * MINT_LOGGO_LOGGER_HASH_TABLE.capacity);
+        MINT_LOGGO_ATOMIC_STORE(&MINT_LOGGO_LOGGER_HASH_TABLE.loggers, loggers);
+
+        // First logger of the process, loggers have to survive a fork from here on
+        Mint_Loggo_WatchForks();
     }
 }
 
 
-// Simple hash
+// Simple polynomial hash, Horner form keeps it in range without pow overflowing
 static int32_t Mint_Loggo_StringHash(const char* name, const int32_t prime, const int32_t buckets) {
-    int32_t hash = 0;
-    const int32_t len = strlen(name);
-    for (int32_t i = 0; i < len; i++) {
-        hash += (int32_t)pow(prime, len - (i+1)) * name[i];
-        hash = hash % buckets;
+    uint32_t hash = 0U;
+    for (const unsigned char* c = (const unsigned char*)name; *c; c++) {
+        hash = (hash * (uint32_t)prime + *c) % (uint32_t)buckets;
     }
-    return hash; 
+    return (int32_t)hash;
+}
+
+
+// Double hash, attempt n looks at (start + n * step) % buckets
+// Capacity is a power of two so an odd step visits every bucket
+static void Mint_Loggo_HTProbe(const char* name, const int32_t buckets, uint32_t* start, uint32_t* step) {
+    *start = (uint32_t)Mint_Loggo_StringHash(name, MINT_LOGGO_PRIME_1, buckets);
+    *step = (uint32_t)Mint_Loggo_StringHash(name, MINT_LOGGO_PRIME_2, buckets) | 1U;
+}
+
+
+// Held for everything that changes the table, logger threads are joined only after it is released
+static void Mint_Loggo_LockRegistry() {
+    MINT_LOGGO_MUTEX_LOCK(MINT_LOGGO_REGISTRY_LOCK);
 }
 
 
-// Double hash
-static int32_t Mint_Loggo_LoggerStringHash(const char* name, const int32_t buckets, const int32_t attempt) {
-    const int32_t hasha = Mint_Loggo_StringHash(name, MINT_LOGGO_PRIME_1, buckets);
-    const int32_t hashb = Mint_Loggo_StringHash(name, MINT_LOGGO_PRIME_2, buckets);
-    return (hasha + (attempt * (hashb + 1))) % buckets;
+static void Mint_Loggo_UnlockRegistry() {
+    MINT_LOGGO_MUTEX_UNLOCK(MINT_LOGGO_REGISTRY_LOCK);
 }
 
 
@@ -0,0 +1,392 @@
+#ifndef MINT_LOGGO_HPP
+#define MINT_LOGGO_HPP
+
+/*
+    Type safe C++17 front end for mint_loggo.h
+
+    Format strings use {} placeholders ({{ and }} for literal braces) and are checked
+    against the arguments at compile time, on C++17 only through MINT_LOGGO_CXX. Arguments are serialized straight into the
+    queued message and only turned into text on the logger thread.
+
+    Still define MINT_LOGGO_IMPLEMENTATION in exactly one C file, this header only wraps the API.
+
+    mint::loggo::Info("http", "request {} took {}us", request_id, micros);
+
+    With C++20 the check happens on the call above. C++17 cant check a function argument at
+    compile time, so there the functions are not checked at all outside MINT__DEBUG builds, which
+    assert at run time. An unchecked mismatch is not an error, extra arguments are appended to the
+    end and the text after the first unfilled {} is dropped. Use the macro to check on C++17
+
+    MINT_LOGGO_CXX(MINT_LOGGO_LEVEL_INFO, "http", "request {} took {}us", request_id, micros);
+
+    Format strings are not copied so only literals are taken, C++20 wants a constant expression
+    and C++17 a const char array.
+    Levels below MINT_LOGGO_CXX_MIN_LEVEL compile to nothing.
+
+    mint::loggo::Span span("trace", "handle_request");
+*/
+
+#include "mint_loggo.h"
+
+#include <charconv>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#ifndef MINT_LOGGO_CXX_MIN_LEVEL
+    #define MINT_LOGGO_CXX_MIN_LEVEL MINT_LOGGO_LEVEL_DEBUG
+#endif
+
+#if defined(__cpp_consteval)
+    #define MINT_LOGGO_CONSTEVAL consteval
+#else
+    #define MINT_LOGGO_CONSTEVAL constexpr
+#endif
+
+
+namespace mint::loggo {
+
+namespace detail {
+
+// Number of {} in fmt or npos when the braces dont pair up
+inline constexpr std::size_t CountPlaceholders(std::string_view fmt) {
+    std::size_t count = 0;
+    for (std::size_t idx = 0; idx < fmt.size(); idx++) {
+        if (fmt[idx] == '{') {
+            if (idx + 1 < fmt.size() && fmt[idx + 1] == '{') {
+                idx++;
+            } else if (idx + 1 < fmt.size() && fmt[idx + 1] == '}') {
+                count++;
+                idx++;
+            } else {
+                return std::string_view::npos;
+            }
+        } else if (fmt[idx] == '}') {
+            if (idx + 1 < fmt.size() && fmt[idx + 1] == '}') {
+                idx++;
+            } else {
+                return std::string_view::npos;
+            }
+        }
+    }
+    return count;
+}
+
+
+template <class T>
+struct TypeIdentity {
+    using type = T;
+};
+
+
+// Used by the macro to count arguments in an unevaluated context
+template <class... Args>
+struct ArgCount {
+    static constexpr std::size_t value = sizeof...(Args);
+};
+
+template <class... Args>
+ArgCount<Args...> CountArgs(const Args&...);
+
+
+// snprintf style writer, counts everything but only copies what fits
+struct Writer {
+    char* out;
+    std::size_t capacity;
+    std::size_t len;
+
+    void Put(const char* text, std::size_t size) {
+        if (len < capacity) {
+            std::size_t room = capacity - len;
+            std::memcpy(out + len, text, size < room ? size : room);
+        }
+        len += size;
+    }
+};
+
+
+// Serialization of one argument, every supported type gets a specialization.
+// Size and Write run on the calling thread, Read renders on the logger thread.
+template <class T, class Enable = void>
+struct Arg {
+    static_assert(sizeof(T) == 0, "mint::loggo: unsupported argument type");
+};
+
+template <>
+struct Arg<bool> {
+    static std::size_t Size(bool) { return 1; }
+    static char* Write(char* dst, bool value) { *dst = value ? 1 : 0; return dst + 1; }
+    static const char* Read(const char* src, Writer& writer) {
+        if (*src) writer.Put("true", 4); else writer.Put("false", 5);
+        return src + 1;
+    }
+};
+
+template <>
+struct Arg<char> {
+    static std::size_t Size(char) { return 1; }
+    static char* Write(char* dst, char value) { *dst = value; return dst + 1; }
+    static const char* Read(const char* src, Writer& writer) { writer.Put(src, 1); return src + 1; }
+};
+
+template <class T>
+struct Arg<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>>> {
+    static std::size_t Size(T) { return sizeof(T); }
+    static char* Write(char* dst, T value) { std::memcpy(dst, &value, sizeof(T)); return dst + sizeof(T); }
+    static const char* Read(const char* src, Writer& writer) {
+        T value;
+        std::memcpy(&value, src, sizeof(T));
+        char buffer[24];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        writer.Put(buffer, static_cast<std::size_t>(result.ptr - buffer));
+        return src + sizeof(T);
+    }
+};
+
+template <class T>
+struct Arg<T, std::enable_if_t<std::is_enum_v<T>>> : Arg<std::underlying_type_t<T>> {
+    static char* Write(char* dst, T value) { return Arg<std::underlying_type_t<T>>::Write(dst, static_cast<std::underlying_type_t<T>>(value)); }
+    static std::size_t Size(T) { return sizeof(std::underlying_type_t<T>); }
+};
+
+template <class T>
+struct Arg<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+    static std::size_t Size(T) { return sizeof(double); }
+    static char* Write(char* dst, T value) {
+        double wide = static_cast<double>(value);
+        std::memcpy(dst, &wide, sizeof(wide));
+        return dst + sizeof(wide);
+    }
+    static const char* Read(const char* src, Writer& writer) {
+        double value;
+        std::memcpy(&value, src, sizeof(value));
+        char buffer[32];
+        int size = std::snprintf(buffer, sizeof(buffer), "%g", value);
+        writer.Put(buffer, static_cast<std::size_t>(size));
+        return src + sizeof(value);
+    }
+};
+
+// Strings are copied because the caller may free them before the logger thread gets to them
+template <>
+struct Arg<std::string_view> {
+    static std::size_t Size(std::string_view value) { return sizeof(std::uint32_t) + value.size(); }
+    static char* Write(char* dst, std::string_view value) {
+        std::uint32_t size = static_cast<std::uint32_t>(value.size());
+        std::memcpy(dst, &size, sizeof(size));
+        std::memcpy(dst + sizeof(size), value.data(), value.size());
+        return dst + sizeof(size) + value.size();
+    }
+    static const char* Read(const char* src, Writer& writer) {
+        std::uint32_t size;
+        std::memcpy(&size, src, sizeof(size));
+        writer.Put(src + sizeof(size), size);
+        return src + sizeof(size) + size;
+    }
+};
+
+template <>
+struct Arg<const char*> : Arg<std::string_view> {
+    static std::size_t Size(const char* value) { return Arg<std::string_view>::Size(value ? value : "(null)"); }
+    static char* Write(char* dst, const char* value) { return Arg<std::string_view>::Write(dst, value ? value : "(null)"); }
+};
+
+template <>
+struct Arg<char*> : Arg<const char*> {};
+
+template <>
+struct Arg<std::string> : Arg<std::string_view> {};
+
+template <std::size_t N>
+struct Arg<char[N]> : Arg<const char*> {};
+
+template <std::size_t N>
+struct Arg<const char[N]> : Arg<const char*> {};
+
+template <class T>
+struct Arg<T*, std::enable_if_t<!std::is_same_v<std::remove_cv_t<T>, char>>> {
+    static std::size_t Size(const T*) { return sizeof(std::uintptr_t); }
+    static char* Write(char* dst, const T* value) {
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(value);
+        std::memcpy(dst, &address, sizeof(address));
+        return dst + sizeof(address);
+    }
+    static const char* Read(const char* src, Writer& writer) {
+        std::uintptr_t address;
+        std::memcpy(&address, src, sizeof(address));
+        char buffer[2 + 2 * sizeof(address)] = {'0', 'x'};
+        auto result = std::to_chars(buffer + 2, buffer + sizeof(buffer), address, 16);
+        writer.Put(buffer, static_cast<std::size_t>(result.ptr - buffer));
+        return src + sizeof(address);
+    }
+};
+
+template <class T>
+using ArgFor = Arg<std::remove_cv_t<std::remove_reference_t<T>>>;
+
+
+// Everything before the next placeholder, unescaping braces on the way
+inline std::size_t PutLiteral(std::string_view fmt, std::size_t pos, Writer& writer) {
+    while (pos < fmt.size()) {
+        char current = fmt[pos];
+        if (current == '{' && pos + 1 < fmt.size() && fmt[pos + 1] == '}') {
+            return pos + 2;
+        }
+        if ((current == '{' || current == '}') && pos + 1 < fmt.size() && fmt[pos + 1] == current) {
+            pos++;
+        }
+        writer.Put(&fmt[pos], 1);
+        pos++;
+    }
+    return pos;
+}
+
+
+// Payload is [format pointer][format length][args...]
+template <class... Args>
+std::size_t Render(const void* payload, char* out, std::size_t capacity) {
+    const char* src = static_cast<const char*>(payload);
+    const char* fmt_data;
+    std::uint32_t fmt_size;
+    std::memcpy(&fmt_data, src, sizeof(fmt_data));
+    std::memcpy(&fmt_size, src + sizeof(fmt_data), sizeof(fmt_size));
+    src += sizeof(fmt_data) + sizeof(fmt_size);
+
+    std::string_view fmt(fmt_data, fmt_size);
+    Writer writer{out, capacity, 0};
+    std::size_t pos = 0;
+    ((pos = PutLiteral(fmt, pos, writer), src = Arg<Args>::Read(src, writer)), ...);
+    PutLiteral(fmt, pos, writer);
+    return writer.len;
+}
+
+
+template <class... Args>
+void Serialize(Mint_Loggo_LogLevel level, const char* name, std::string_view fmt, const Args&... args) {
+    const char* fmt_data = fmt.data();
+    std::uint32_t fmt_size = static_cast<std::uint32_t>(fmt.size());
+    std::size_t size = sizeof(fmt_data) + sizeof(fmt_size) + (std::size_t{0} + ... + ArgFor<Args>::Size(args));
+
+    Mint_Loggo_Deferred deferred = Mint_Loggo_BeginDeferred(name, level, &Render<std::remove_cv_t<std::remove_reference_t<Args>>...>, size);
+    if (!deferred.payload) {
+        return;
+    }
+
+    char* dst = static_cast<char*>(deferred.payload);
+    std::memcpy(dst, &fmt_data, sizeof(fmt_data));
+    std::memcpy(dst + sizeof(fmt_data), &fmt_size, sizeof(fmt_size));
+    dst += sizeof(fmt_data) + sizeof(fmt_size);
+    ((dst = ArgFor<Args>::Write(dst, args)), ...);
+    Mint_Loggo_CommitDeferred(deferred);
+}
+
+} // namespace detail
+
+
+// Format string checked against its arguments with C++20, the check is a compile error
+// C++17 leaves the check to MINT_LOGGO_CXX
+// The queued message only keeps a pointer to it, so anything built at run time is turned away
+template <class... Args>
+struct FormatString {
+    std::string_view str;
+
+    #if defined(__cpp_consteval)
+        template <class S, std::enable_if_t<std::is_convertible_v<const S&, std::string_view>, int> = 0>
+        MINT_LOGGO_CONSTEVAL FormatString(const S& fmt) : str(fmt) {
+            if (detail::CountPlaceholders(str) != sizeof...(Args)) {
+                throw "mint::loggo: format string does not match the arguments";
+            }
+        }
+    #else
+        // Without consteval a literal is the closest thing to a constant, writable buffers are refused
+        template <std::size_t N>
+        constexpr FormatString(const char (&fmt)[N]) : str(fmt) {}
+
+        template <std::size_t N>
+        FormatString(char (&fmt)[N]) = delete;
+    #endif
+};
+
+template <class... Args>
+using CheckedFormat = FormatString<typename detail::TypeIdentity<Args>::type...>;
+
+
+// Without arguments or braces to unescape the format is the message, it is borrowed like the deferred path does
+template <Mint_Loggo_LogLevel Level, class... Args>
+inline void Log(const char* name, CheckedFormat<Args...> fmt, const Args&... args) {
+    if constexpr (Level >= MINT_LOGGO_CXX_MIN_LEVEL) {
+        #if !defined(__cpp_consteval) && defined(MINT__DEBUG)
+            assert(detail::CountPlaceholders(fmt.str) == sizeof...(Args));
+        #endif
+        if constexpr (sizeof...(Args) == 0) {
+            if (fmt.str.find_first_of("{}") == std::string_view::npos) {
+                Mint_Loggo_LogStatic(name, Level, fmt.str.data(), fmt.str.size());
+                return;
+            }
+        }
+        detail::Serialize(Level, name, fmt.str, args...);
+    }
+}
+
+template <class... Args>
+inline void Debug(const char* name, CheckedFormat<Args...> fmt, const Args&... args) { Log<MINT_LOGGO_LEVEL_DEBUG>(name, fmt, args...); }
+
+template <class... Args>
+inline void Info(const char* name, CheckedFormat<Args...> fmt, const Args&... args) { Log<MINT_LOGGO_LEVEL_INFO>(name, fmt, args...); }
+
+template <class... Args>
+inline void Warn(const char* name, CheckedFormat<Args...> fmt, const Args&... args) { Log<MINT_LOGGO_LEVEL_WARN>(name, fmt, args...); }
+
+template <class... Args>
+inline void Error(const char* name, CheckedFormat<Args...> fmt, const Args&... args) { Log<MINT_LOGGO_LEVEL_ERROR>(name, fmt, args...); }
+
+template <class... Args>
+inline void Fatal(const char* name, CheckedFormat<Args...> fmt, const Args&... args) { Log<MINT_LOGGO_LEVEL_FATAL>(name, fmt, args...); }
+
+
+// Trace span for the lifetime of the object, span must be a literal like the C API
+class Span {
+public:
+    Span(const char* name, const char* span) : name_(name), span_(span) { Mint_Loggo_TraceBegin(name_, span_); }
+    ~Span() { Mint_Loggo_TraceEnd(name_, span_); }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+private:
+    const char* name_;
+    const char* span_;
+};
+
+
+// Context field on the calling thread for the lifetime of the object
+class Context {
+public:
+    Context(const char* key, const char* value) : key_(key) { Mint_Loggo_ContextSet(key_, value); }
+    ~Context() { Mint_Loggo_ContextSet(key_, nullptr); }
+
+    Context(const Context&) = delete;
+    Context& operator=(const Context&) = delete;
+
+private:
+    const char* key_;
+};
+
+} // namespace mint::loggo
+
+
+// Checks the format at compile time on C++17 too, fmt must be a string literal
+#define MINT_LOGGO_CXX(level, name, fmt, ...) \
+    do { \
+        static_assert(::mint::loggo::detail::CountPlaceholders("" fmt "") == \
+                      decltype(::mint::loggo::detail::CountArgs(__VA_ARGS__))::value, \
+                      "mint::loggo: format string does not match the arguments"); \
+        ::mint::loggo::Log<(level)>((name), (fmt), ##__VA_ARGS__); \
+    } while (0)
+
+#endif // MINT_LOGGO_HPP
@@ -0,0 +1,137 @@
+// p99 of Mint_Loggo_Log on the null sink against a stored baseline
+//
+// loggo_latency [-b baseline] [-n messages] [-r]
+//   baseline   file holding "p99_ns <value>", defaults to latency_baseline.txt
+//   messages   timed calls per round, defaults to 200000
+//   -r         write this run's p99 as the new baseline instead of comparing
+//
+// The best p99 of a few rounds is used so one noisy round doesnt fail the run. It fails when that is
+// more than LOGGO_LATENCY_TOLERANCE (default 3) times the baseline, the baseline is machine specific
+// so record one again (-r) when the test moves to other hardware.
+#define MINT_LOGGO_IMPLEMENTATION
+#include "mint_loggo.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#define LATENCY_ROUNDS 5U
+#define LATENCY_WARMUP 10000U
+#define LATENCY_DEFAULT_TOLERANCE 3.0
+
+
+static uint64_t NowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000U + (uint64_t)now.tv_nsec;
+}
+
+
+static int CompareNs(const void* left, const void* right) {
+    uint64_t a = *(const uint64_t*)left;
+    uint64_t b = *(const uint64_t*)right;
+    return (a > b) - (a < b);
+}
+
+
+// One round on a fresh logger, the queue is big enough that a call only waits on a full queue
+// when the logger thread falls behind, which is part of what is being measured
+static uint64_t MeasureRound(uint64_t* samples, uint32_t messages) {
+    Mint_Loggo_CreateLogger("latency",
+        &(Mint_Loggo_LogFormat){.level = MINT_LOGGO_LEVEL_DEBUG, .queue_capacity = 65536U},
+        &(Mint_Loggo_LogHandler){.handle = stdout, .write_handler = Mint_Loggo_NullWrite});
+
+    for (uint32_t idx = 0; idx < LATENCY_WARMUP; idx++) {
+        Mint_Loggo_Log("latency", MINT_LOGGO_LEVEL_INFO, "request id=42 path=/api/v1/items status=200 bytes=512");
+    }
+
+    for (uint32_t idx = 0; idx < messages; idx++) {
+        uint64_t start = NowNs();
+        Mint_Loggo_Log("latency", MINT_LOGGO_LEVEL_INFO, "request id=42 path=/api/v1/items status=200 bytes=512");
+        samples[idx] = NowNs() - start;
+    }
+    Mint_Loggo_DeleteLogger("latency");
+
+    qsort(samples, messages, sizeof(uint64_t), CompareNs);
+    return samples[(size_t)messages * 99U / 100U];
+}
+
+
+static bool ReadBaseline(const char* path, uint64_t* p99) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+
+    unsigned long long value = 0U;
+    bool read = fscanf(file, "p99_ns %llu", &value) == 1;
+    fclose(file);
+    *p99 = (uint64_t)value;
+    return read && value > 0U;
+}
+
+
+int main(int argc, char** argv) {
+    const char* baseline_path = "latency_baseline.txt";
+    uint32_t messages = 200000U;
+    bool record = false;
+
+    for (int idx = 1; idx < argc; idx++) {
+        if (strcmp(argv[idx], "-b") == 0 && idx + 1 < argc) {
+            baseline_path = argv[++idx];
+        } else if (strcmp(argv[idx], "-n") == 0 && idx + 1 < argc) {
+            messages = (uint32_t)strtoul(argv[++idx], NULL, 10);
+        } else if (strcmp(argv[idx], "-r") == 0) {
+            record = true;
+        } else {
+            fprintf(stderr, "usage: loggo_latency [-b baseline] [-n messages] [-r]\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (messages < 100U) {
+        fprintf(stderr, "messages must be at least 100\n");
+        return EXIT_FAILURE;
+    }
+
+    uint64_t* samples = malloc(sizeof(uint64_t) * messages);
+    uint64_t best = UINT64_MAX;
+    for (uint32_t round = 0; round < LATENCY_ROUNDS; round++) {
+        uint64_t p99 = MeasureRound(samples, messages);
+        best = p99 < best ? p99 : best;
+    }
+    free(samples);
+
+    if (record) {
+        FILE* file = fopen(baseline_path, "w");
+        if (!file) {
+            fprintf(stderr, "Could not write %s\n", baseline_path);
+            return EXIT_FAILURE;
+        }
+        fprintf(file, "p99_ns %llu\n", (unsigned long long)best);
+        fclose(file);
+        printf("p99 %llu ns recorded to %s\n", (unsigned long long)best, baseline_path);
+        return EXIT_SUCCESS;
+    }
+
+    uint64_t baseline = 0U;
+    if (!ReadBaseline(baseline_path, &baseline)) {
+        fprintf(stderr, "Could not read a baseline from %s\n", baseline_path);
+        return EXIT_FAILURE;
+    }
+
+    double tolerance = LATENCY_DEFAULT_TOLERANCE;
+    const char* tolerance_env = getenv("LOGGO_LATENCY_TOLERANCE");
+    if (tolerance_env && atof(tolerance_env) > 0.0) {
+        tolerance = atof(tolerance_env);
+    }
+
+    double limit = (double)baseline * tolerance;
+    bool passed = (double)best <= limit;
+    printf("p99 %llu ns, baseline %llu ns, limit %.0f ns: %s\n", (unsigned long long)best,
+           (unsigned long long)baseline, limit, passed ? "ok" : "REGRESSED");
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,186 @@
+// Live reconfiguration racing the logger going away
+//
+// loggo_reconfigure [-n cycles]
+//   cycles     times the logger is created and deleted, defaults to 2000
+//
+// One thread keeps creating, logging to and deleting the same name, cycling through the kinds of
+// logger, while another swaps its handler and another changes colors and flush. Shutdown then runs
+// with the setters still going. A call can find the logger right before it is deleted, so it must
+// either make its change or refuse it, never hang or touch a freed logger. Each handle the setter
+// hands over is retired once it is refused, replaced on the same logger or its logger is deleted,
+// the sink counts any write that reaches a retired handle.
+#define MINT_LOGGO_IMPLEMENTATION
+#include "mint_loggo.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#define RECONFIGURE_HANDLES 64U
+#define RECONFIGURE_MESSAGES 8U
+
+typedef struct {
+    uint32_t retired;
+    uint64_t writes;
+    bool in_use;            // Handed to a logger and not retired yet, only the setter uses it
+    uint32_t bound;         // Latest generation whose logger it can be on
+} Reconfigure_Sink;
+
+static const char* const logger_name = "race";
+static Reconfigure_Sink churn_sink = {0};
+static Reconfigure_Sink handles[RECONFIGURE_HANDLES];
+static uint32_t cycles = 2000U;
+static uint32_t stop = 0U;
+static uint32_t generation = 0U;   // Odd while a logger exists, bumped after each create and delete
+static uint64_t late_writes = 0U;
+static uint64_t swaps = 0U;
+static uint64_t refused = 0U;
+
+static Mint_Loggo_LogFormat formats[] = {
+    {.level = MINT_LOGGO_LEVEL_DEBUG, .queue_capacity = 16U},
+    {.level = MINT_LOGGO_LEVEL_DEBUG, .queue_capacity = 16U, .lazy = true},
+    {.level = MINT_LOGGO_LEVEL_DEBUG, .queue_capacity = 16U, .threadless = true},
+    {.level = MINT_LOGGO_LEVEL_DEBUG, .queue_capacity = 8U, .pool_slots = 4U},
+    {.level = MINT_LOGGO_LEVEL_DEBUG, .queue_capacity = 16U, .priority = MINT_LOGGO_PRIORITY_SYNC},
+};
+
+#define RECONFIGURE_FORMATS (sizeof(formats) / sizeof(formats[0]))
+
+
+static int CountWrite(char* text, void* arg) {
+    (void)text;
+    Reconfigure_Sink* sink = arg;
+    if (MINT_LOGGO_ATOMIC_LOAD(&sink->retired)) {
+        MINT_LOGGO_ATOMIC_ADD(&late_writes, 1U);
+    }
+    MINT_LOGGO_ATOMIC_ADD(&sink->writes, 1U);
+    return 0;
+}
+
+
+static int CountFlush(void* arg) {
+    (void)arg;
+    return 0;
+}
+
+
+// A handle is only handed out again after it was retired
+static Reconfigure_Sink* NextHandle(uint32_t* next) {
+    for (;;) {
+        Reconfigure_Sink* sink = &handles[(*next)++ % RECONFIGURE_HANDLES];
+        if (!sink->in_use) {
+            return sink;
+        }
+    }
+}
+
+
+// Once the generation moves past bound the logger the handle was on has been deleted
+static void RetireHandles(uint32_t now, uint32_t replaced) {
+    for (uint32_t idx = 0; idx < RECONFIGURE_HANDLES; idx++) {
+        Reconfigure_Sink* sink = &handles[idx];
+        if (sink->in_use && (now > sink->bound || sink->bound == replaced)) {
+            MINT_LOGGO_ATOMIC_STORE(&sink->retired, 1U);
+            sink->in_use = false;
+        }
+    }
+}
+
+
+static void* SwapHandlers(void* arg) {
+    (void)arg;
+    uint32_t next = 0U;
+    while (!MINT_LOGGO_ATOMIC_LOAD(&stop)) {
+        Reconfigure_Sink* sink = NextHandle(&next);
+        MINT_LOGGO_ATOMIC_STORE(&sink->retired, 0U);
+        uint32_t before = MINT_LOGGO_ATOMIC_LOAD(&generation);
+        bool swapped = Mint_Loggo_SetHandler(logger_name, &(Mint_Loggo_LogHandler){.handle = sink, .write_handler = CountWrite, .flush_handler = CountFlush});
+        uint32_t after = MINT_LOGGO_ATOMIC_LOAD(&generation);
+
+        // A refused handle is never touched. With the same logger all along the swap replaced the handles before it
+        RetireHandles(after, swapped && before == after && after % 2U ? after : 0U);
+        if (swapped) {
+            sink->in_use = true;
+            sink->bound = after % 2U ? after : after - 1U;
+            swaps++;
+        } else {
+            MINT_LOGGO_ATOMIC_STORE(&sink->retired, 1U);
+            refused++;
+        }
+    }
+    return NULL;
+}
+
+
+static void* ChangeSettings(void* arg) {
+    (void)arg;
+    for (uint32_t idx = 0; !MINT_LOGGO_ATOMIC_LOAD(&stop); idx++) {
+        Mint_Loggo_SetColors(logger_name, idx % 2U == 0U);
+        Mint_Loggo_SetFlush(logger_name, idx % 3U == 0U);
+    }
+    return NULL;
+}
+
+
+static void* PollThreadless(void* arg) {
+    (void)arg;
+    while (!MINT_LOGGO_ATOMIC_LOAD(&stop)) {
+        if (!Mint_Loggo_Poll(64U)) {
+            MINT_LOGGO_THREAD_YIELD();
+        }
+    }
+    return NULL;
+}
+
+
+int main(int argc, char** argv) {
+    for (int idx = 1; idx < argc; idx++) {
+        if (strcmp(argv[idx], "-n") == 0 && idx + 1 < argc) {
+            cycles = (uint32_t)strtoul(argv[++idx], NULL, 10);
+        } else {
+            fprintf(stderr, "usage: loggo_reconfigure [-n cycles]\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    pthread_t swapper;
+    pthread_t changer;
+    pthread_t poller;
+    pthread_create(&swapper, NULL, SwapHandlers, NULL);
+    pthread_create(&changer, NULL, ChangeSettings, NULL);
+    pthread_create(&poller, NULL, PollThreadless, NULL);
+
+    Mint_Loggo_LogHandler handler = {.handle = &churn_sink, .write_handler = CountWrite, .flush_handler = CountFlush};
+    for (uint32_t idx = 0; idx < cycles; idx++) {
+        if (Mint_Loggo_CreateLogger(logger_name, &formats[idx % RECONFIGURE_FORMATS], &handler) == -1) {
+            fprintf(stderr, "Could not create %s\n", logger_name);
+            return EXIT_FAILURE;
+        }
+        MINT_LOGGO_ATOMIC_ADD(&generation, 1U);
+        for (uint32_t msg = 0; msg < RECONFIGURE_MESSAGES; msg++) {
+            Mint_Loggo_Log(logger_name, MINT_LOGGO_LEVEL_INFO, "racing the setters");
+        }
+        Mint_Loggo_DeleteLogger(logger_name);
+        MINT_LOGGO_ATOMIC_ADD(&generation, 1U);
+    }
+
+    // Last one goes with Shutdown while everything is still running
+    Mint_Loggo_CreateLogger(logger_name, &formats[0], &handler);
+    MINT_LOGGO_ATOMIC_ADD(&generation, 1U);
+    Mint_Loggo_Log(logger_name, MINT_LOGGO_LEVEL_INFO, "racing shutdown");
+    Mint_Loggo_Shutdown(0U);
+    MINT_LOGGO_ATOMIC_ADD(&generation, 1U);
+
+    MINT_LOGGO_ATOMIC_STORE(&stop, 1U);
+    pthread_join(swapper, NULL);
+    pthread_join(changer, NULL);
+    pthread_join(poller, NULL);
+
+    bool passed = late_writes == 0U;
+    printf("%u cycles, %llu handlers swapped, %llu refused, %llu writes to retired handles: %s\n", cycles,
+           (unsigned long long)swaps, (unsigned long long)refused, (unsigned long long)late_writes, passed ? "ok" : "FAILED");
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,201 @@
+// Sanitizing what goes on a line
+//
+// loggo_sanitize
+//
+// Every byte value is put at every offset of clean text of every length up to a few blocks past
+// the 32 byte one, at a few alignments, and ScanClean and SanitizeCopy (escaped, stripped and JSON)
+// are checked against a byte at a time reference. Built once per scan path: the default, -mavx2
+// where the machine has it and MINT_LOGGO_NO_SIMD for the scalar one.
+// Context values set with a newline and a quote come out of text loggers the way the format sanitizes
+// the message (as set, escaped or stripped) and escaped in JSON, so they never break a line in two.
+#define MINT_LOGGO_IMPLEMENTATION
+#include "mint_loggo.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SANITIZE_CAPTURE_MAX 4096U
+#define SANITIZE_SCAN_MAX 72U           // Two AVX2 blocks, an SSE2 block and a scalar tail
+#define SANITIZE_ALIGNMENTS 4U
+
+#if defined(MINT_LOGGO_NO_SIMD)
+    #define SANITIZE_PATH "scalar"
+#elif defined(__AVX2__)
+    #define SANITIZE_PATH "avx2"
+#elif defined(__SSE2__) || defined(_M_X64)
+    #define SANITIZE_PATH "sse2"
+#else
+    #define SANITIZE_PATH "scalar"
+#endif
+
+typedef struct {
+    char text[SANITIZE_CAPTURE_MAX];
+    size_t len;
+} Sanitize_Capture;
+
+static uint32_t failures = 0U;
+
+
+static void Expect(bool passed, const char* what) {
+    if (!passed) {
+        fprintf(stderr, "FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+
+static int CaptureWrite(char* text, void* arg) {
+    Sanitize_Capture* capture = arg;
+    size_t len = strlen(text);
+    if (capture->len + len < SANITIZE_CAPTURE_MAX) {
+        memcpy(capture->text + capture->len, text, len);
+        capture->len += len;
+        capture->text[capture->len] = '\0';
+    }
+    return 0;
+}
+
+
+static int CaptureFlush(void* arg) {
+    (void)arg;
+    return 0;
+}
+
+
+static size_t ReferenceScan(const char* text, size_t len) {
+    size_t idx = 0U;
+    while (idx < len && !MINT_LOGGO_NEEDS_SANITIZE(text[idx])) {
+        idx++;
+    }
+    return idx;
+}
+
+
+// What SanitizeCopy promises, one byte at a time
+static size_t ReferenceCopy(char* out, const char* text, size_t len, Mint_Loggo_Sanitize mode, bool json) {
+    static const char hex[] = "0123456789abcdef";
+    size_t written = 0U;
+    for (size_t idx = 0U; idx < len; idx++) {
+        unsigned char current = (unsigned char)text[idx];
+        if (!MINT_LOGGO_NEEDS_SANITIZE(current)) {
+            out[written++] = (char)current;
+        } else if (current == '"' || current == '\\') {
+            if (json || mode == MINT_LOGGO_SANITIZE_ESCAPE) {
+                out[written++] = '\\';
+            }
+            out[written++] = (char)current;
+        } else if (mode == MINT_LOGGO_SANITIZE_STRIP) {
+            continue;
+        } else if (current == '\n' || current == '\r' || current == '\t') {
+            out[written++] = '\\';
+            out[written++] = current == '\n' ? 'n' : current == '\r' ? 'r' : 't';
+        } else if (json) {
+            written += (size_t)sprintf(out + written, "\\u00%c%c", hex[current >> 4U], hex[current & 0xFU]);
+        } else {
+            written += (size_t)sprintf(out + written, "\\x%c%c", hex[current >> 4U], hex[current & 0xFU]);
+        }
+    }
+    return written;
+}
+
+
+static bool SameCopy(const char* text, size_t len, Mint_Loggo_Sanitize mode, bool json) {
+    char expected[SANITIZE_SCAN_MAX * 6U];
+    char got[SANITIZE_SCAN_MAX * 6U];
+    size_t expected_len = ReferenceCopy(expected, text, len, mode, json);
+    size_t got_len = Mint_Loggo_SanitizeCopy(got, text, len, mode, json);
+    return expected_len == got_len && memcmp(expected, got, got_len) == 0;
+}
+
+
+// One byte that may need a look in otherwise clean text. The byte right after len always does, so a
+// block that reads past len is caught by a wrong answer
+static void TestScan() {
+    char buffer[SANITIZE_SCAN_MAX + SANITIZE_ALIGNMENTS + 32U];
+    uint32_t scan_fails = 0U;
+    uint32_t copy_fails = 0U;
+    for (uint32_t align = 0; align < SANITIZE_ALIGNMENTS; align++) {
+        char* text = buffer + align;
+        for (uint32_t value = 0; value < 256U; value++) {
+            for (size_t len = 1U; len <= SANITIZE_SCAN_MAX; len++) {
+                for (size_t offset = 0U; offset < len; offset++) {
+                    memset(buffer, 'a', sizeof(buffer));
+                    text[offset] = (char)value;
+                    text[len] = '"';
+
+                    scan_fails += Mint_Loggo_ScanClean(text, len) != ReferenceScan(text, len) ? 1U : 0U;
+                    copy_fails += SameCopy(text, len, MINT_LOGGO_SANITIZE_ESCAPE, false) ? 0U : 1U;
+                    copy_fails += SameCopy(text, len, MINT_LOGGO_SANITIZE_STRIP, false) ? 0U : 1U;
+                    copy_fails += SameCopy(text, len, MINT_LOGGO_SANITIZE_ESCAPE, true) ? 0U : 1U;
+                }
+            }
+        }
+    }
+    Expect(scan_fails == 0U, "scan: ScanClean matches the reference for every byte, offset and length");
+    Expect(copy_fails == 0U, "scan: SanitizeCopy matches the reference for every byte, offset and length");
+
+    // Clean text of every length scans to its end, a blocked path must not stop short at a block edge
+    uint32_t clean_fails = 0U;
+    memset(buffer, 'a', sizeof(buffer));
+    for (size_t len = 0U; len <= SANITIZE_SCAN_MAX; len++) {
+        buffer[len] = '\n';
+        clean_fails += Mint_Loggo_ScanClean(buffer, len) != len ? 1U : 0U;
+        buffer[len] = 'a';
+    }
+    Expect(clean_fails == 0U, "scan: clean text scans to its end");
+}
+
+
+static uint32_t CountLines(const Sanitize_Capture* capture) {
+    uint32_t lines = 0U;
+    for (size_t idx = 0U; idx < capture->len; idx++) {
+        lines += capture->text[idx] == '\n' ? 1U : 0U;
+    }
+    return lines;
+}
+
+
+// One line logged with the context set, deleting the logger writes it out
+static void LogWithContext(const char* name, Mint_Loggo_LogFormat* format, Sanitize_Capture* capture) {
+    memset(capture, 0U, sizeof(*capture));
+    Mint_Loggo_CreateLogger(name, format, &(Mint_Loggo_LogHandler){.handle = capture, .write_handler = CaptureWrite, .flush_handler = CaptureFlush});
+    Mint_Loggo_Log(name, MINT_LOGGO_LEVEL_INFO, "after the context");
+    Mint_Loggo_DeleteLogger(name);
+}
+
+
+static void TestContext() {
+    Sanitize_Capture capture;
+    Expect(Mint_Loggo_ContextSet("user", "a\nb\"c"), "context: set");
+
+    LogWithContext("escape", &(Mint_Loggo_LogFormat){.sanitize = MINT_LOGGO_SANITIZE_ESCAPE}, &capture);
+    Expect(strstr(capture.text, "user=a\\nb\\\"c ") != NULL, "context: escaped in text");
+    Expect(CountLines(&capture) == 1U, "context: escaped value stays on its line");
+
+    LogWithContext("strip", &(Mint_Loggo_LogFormat){.sanitize = MINT_LOGGO_SANITIZE_STRIP}, &capture);
+    Expect(strstr(capture.text, "user=ab\"c ") != NULL, "context: stripped in text");
+    Expect(CountLines(&capture) == 1U, "context: stripped value stays on its line");
+
+    LogWithContext("json", &(Mint_Loggo_LogFormat){.output = MINT_LOGGO_OUTPUT_JSON}, &capture);
+    Expect(strstr(capture.text, "\"user\":\"a\\nb\\\"c\"") != NULL, "context: escaped in JSON");
+    Expect(CountLines(&capture) == 1U, "context: JSON value stays on its line");
+
+    // Without sanitizing the context goes out as set, like the message would
+    LogWithContext("raw", &(Mint_Loggo_LogFormat){.sanitize = MINT_LOGGO_SANITIZE_NONE}, &capture);
+    Expect(strstr(capture.text, "user=a\nb\"c ") != NULL, "context: as set without sanitizing");
+
+    Mint_Loggo_ContextClear();
+}
+
+
+int main() {
+    TestScan();
+    TestContext();
+
+    Mint_Loggo_Shutdown(0U);
+    printf("sanitize (%s): %s\n", SANITIZE_PATH, failures ? "FAILED" : "ok");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
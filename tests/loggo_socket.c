@@ -0,0 +1,272 @@
+// Socket sink against a local unix socket listener
+//
+// loggo_socket
+//
+// Drives the sink the way a logger thread does, writes then flushes, and reads what comes out on the
+// other end. Covers records batching into one send, frames kept and resent after the peer goes
+// away and comes back, both drop policies with no peer at all, the dropped count, and a logger
+// writing through the sink. Records are fixed size and numbered so the reader can tell which made it.
+#define MINT_LOGGO_IMPLEMENTATION
+#include "mint_loggo.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define SOCKET_RECORD_SIZE 16U
+#define SOCKET_READ_MAX 65536U
+#define SOCKET_QUIET_MS 50
+#define SOCKET_RECONNECT_TRIES 200U
+
+static char socket_path[64];
+static uint32_t failures = 0U;
+
+
+static void Expect(bool passed, const char* what) {
+    if (!passed) {
+        fprintf(stderr, "FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+
+static int Listen() {
+    struct sockaddr_un address = {.sun_family = AF_UNIX};
+    strcpy(address.sun_path, socket_path);
+    unlink(socket_path);
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 || bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 4) != 0) {
+        fprintf(stderr, "Could not listen on %s\n", socket_path);
+        exit(EXIT_FAILURE);
+    }
+    return listener;
+}
+
+
+static void StopListening(int listener) {
+    close(listener);
+    unlink(socket_path);
+}
+
+
+// Every record is "record NNNNNNNN\n", exactly SOCKET_RECORD_SIZE bytes
+static void WriteRecord(Mint_Loggo_SocketSink* sink, uint32_t number, int* result) {
+    char text[SOCKET_RECORD_SIZE + 1U];
+    snprintf(text, sizeof(text), "record %08u\n", number);
+    *result = Mint_Loggo_SocketWrite(text, sink);
+}
+
+
+// Whatever arrives until the connection has been quiet for a while
+static size_t ReadQuiet(int conn, char* buffer) {
+    size_t len = 0U;
+    struct pollfd waiter = {.fd = conn, .events = POLLIN};
+    while (len < SOCKET_READ_MAX && poll(&waiter, 1, SOCKET_QUIET_MS) > 0) {
+        ssize_t got = read(conn, buffer + len, SOCKET_READ_MAX - len);
+        if (got <= 0) {
+            break;
+        }
+        len += (size_t)got;
+    }
+    return len;
+}
+
+
+// The numbers of the records in buffer, false when one is torn or malformed
+static bool ParseRecords(const char* buffer, size_t len, uint32_t* numbers, uint32_t* count) {
+    *count = 0U;
+    if (len % SOCKET_RECORD_SIZE != 0U) {
+        return false;
+    }
+    for (size_t offset = 0U; offset < len; offset += SOCKET_RECORD_SIZE) {
+        unsigned number = 0U;
+        if (sscanf(buffer + offset, "record %8u\n", &number) != 1 || buffer[offset + SOCKET_RECORD_SIZE - 1U] != '\n') {
+            return false;
+        }
+        numbers[(*count)++] = number;
+    }
+    return true;
+}
+
+
+// Keep flushing until the sink reconnects and has nothing left, its backoff decides how long that takes
+static bool FlushUntilEmpty(Mint_Loggo_SocketSink* sink) {
+    for (uint32_t idx = 0; idx < SOCKET_RECONNECT_TRIES; idx++) {
+        if (Mint_Loggo_SocketFlush(sink) == 0) {
+            return true;
+        }
+        usleep(10000U);
+    }
+    return false;
+}
+
+
+// Records that fit one frame stay put until a flush and then go out in a single send
+static void TestBatching(char* buffer, uint32_t* numbers) {
+    int listener = Listen();
+    Mint_Loggo_SocketSink* sink = Mint_Loggo_SocketOpen(&(Mint_Loggo_SocketConfig){.path = socket_path, .frame_size = 8U * SOCKET_RECORD_SIZE, .reconnect_ms = 10U});
+    Expect(sink != NULL, "batching: sink opens");
+    int conn = accept(listener, NULL, NULL);
+
+    int result = 0;
+    for (uint32_t idx = 0; idx < 6U; idx++) {
+        WriteRecord(sink, idx, &result);
+        Expect(result == (int)SOCKET_RECORD_SIZE, "batching: write takes the whole record");
+    }
+    Expect(ReadQuiet(conn, buffer) == 0U, "batching: nothing is sent before the frame fills or is flushed");
+
+    Expect(Mint_Loggo_SocketFlush(sink) == 0, "batching: flush empties the sink");
+    uint32_t count = 0U;
+    size_t len = 0U;
+    ssize_t got = recv(conn, buffer, SOCKET_READ_MAX, MSG_DONTWAIT);
+    len = got > 0 ? (size_t)got : 0U;
+    Expect(len == 6U * SOCKET_RECORD_SIZE, "batching: the flushed frame arrives in one read");
+
+    // A full frame goes out on the write that opens the next one, no flush needed
+    for (uint32_t idx = 6U; idx < 20U; idx++) {
+        WriteRecord(sink, idx, &result);
+    }
+    len += ReadQuiet(conn, buffer + len);
+    Expect(len == 14U * SOCKET_RECORD_SIZE, "batching: closed frames are sent without a flush");
+
+    Mint_Loggo_SocketFlush(sink);
+    len += ReadQuiet(conn, buffer + len);
+    Expect(ParseRecords(buffer, len, numbers, &count) && count == 20U, "batching: every record arrives whole");
+    for (uint32_t idx = 0; idx < count; idx++) {
+        Expect(numbers[idx] == idx, "batching: records arrive in order");
+    }
+    Expect(Mint_Loggo_SocketDropped(sink) == 0U, "batching: nothing dropped");
+
+    Mint_Loggo_SocketClose(sink);
+    close(conn);
+    StopListening(listener);
+}
+
+
+// Records written while the peer is gone are kept and sent once it listens again
+static void TestReconnect(char* buffer, uint32_t* numbers) {
+    int listener = Listen();
+    Mint_Loggo_SocketSink* sink = Mint_Loggo_SocketOpen(&(Mint_Loggo_SocketConfig){.path = socket_path, .frame_size = 4U * SOCKET_RECORD_SIZE, .reconnect_ms = 5U});
+    int conn = accept(listener, NULL, NULL);
+
+    int result = 0;
+    for (uint32_t idx = 0; idx < 4U; idx++) {
+        WriteRecord(sink, idx, &result);
+    }
+    Mint_Loggo_SocketFlush(sink);
+    size_t len = ReadQuiet(conn, buffer);
+    Expect(len == 4U * SOCKET_RECORD_SIZE, "reconnect: first records arrive");
+
+    // Peer goes away, the sink notices on its next send
+    close(conn);
+    StopListening(listener);
+    for (uint32_t idx = 4U; idx < 16U; idx++) {
+        WriteRecord(sink, idx, &result);
+        Expect(result == (int)SOCKET_RECORD_SIZE, "reconnect: writes are buffered while the peer is gone");
+    }
+    Expect(Mint_Loggo_SocketFlush(sink) == -1, "reconnect: flush reports what is still buffered");
+
+    listener = Listen();
+    Expect(FlushUntilEmpty(sink), "reconnect: sink reconnects and drains");
+    conn = accept(listener, NULL, NULL);
+    len = ReadQuiet(conn, buffer);
+
+    uint32_t count = 0U;
+    Expect(ParseRecords(buffer, len, numbers, &count) && count == 12U, "reconnect: buffered records arrive whole");
+    for (uint32_t idx = 0; idx < count; idx++) {
+        Expect(numbers[idx] == idx + 4U, "reconnect: buffered records arrive in order");
+    }
+    Expect(Mint_Loggo_SocketDropped(sink) == 0U, "reconnect: nothing dropped");
+
+    Mint_Loggo_SocketClose(sink);
+    close(conn);
+    StopListening(listener);
+}
+
+
+// Two frames of two records and no peer, ten records leave room for four of them
+static void TestOverflow(Mint_Loggo_OverflowPolicy overflow, uint32_t first_kept, const char* name, char* buffer, uint32_t* numbers) {
+    unlink(socket_path);
+    Mint_Loggo_SocketSink* sink = Mint_Loggo_SocketOpen(&(Mint_Loggo_SocketConfig){.path = socket_path, .frame_size = 2U * SOCKET_RECORD_SIZE,
+                                                        .buffer_size = 4U * SOCKET_RECORD_SIZE, .reconnect_ms = 5U, .overflow = overflow});
+    Expect(sink != NULL, name);
+
+    int result = 0;
+    uint32_t refused = 0U;
+    for (uint32_t idx = 0; idx < 10U; idx++) {
+        WriteRecord(sink, idx, &result);
+        refused += result == -1 ? 1U : 0U;
+    }
+    Expect(Mint_Loggo_SocketDropped(sink) == 6U, name);
+    Expect(refused == (overflow == MINT_LOGGO_OVERFLOW_DROP_NEWEST ? 6U : 0U), name);
+
+    int listener = Listen();
+    Expect(FlushUntilEmpty(sink), name);
+    int conn = accept(listener, NULL, NULL);
+    size_t len = ReadQuiet(conn, buffer);
+
+    uint32_t count = 0U;
+    Expect(ParseRecords(buffer, len, numbers, &count) && count == 4U, name);
+    for (uint32_t idx = 0; idx < count; idx++) {
+        Expect(numbers[idx] == first_kept + idx, name);
+    }
+
+    Mint_Loggo_SocketClose(sink);
+    close(conn);
+    StopListening(listener);
+}
+
+
+// A logger writing through the sink, deleting it sends what is left
+static void TestLogger(char* buffer) {
+    int listener = Listen();
+    Mint_Loggo_SocketSink* sink = Mint_Loggo_SocketOpen(&(Mint_Loggo_SocketConfig){.path = socket_path, .reconnect_ms = 10U});
+    int conn = accept(listener, NULL, NULL);
+
+    int32_t id = Mint_Loggo_CreateLogger("socket",
+        &(Mint_Loggo_LogFormat){.level = MINT_LOGGO_LEVEL_DEBUG},
+        &(Mint_Loggo_LogHandler){.handle = sink, .write_handler = Mint_Loggo_SocketWrite, .flush_handler = Mint_Loggo_SocketFlush});
+    Expect(id != -1, "logger: created");
+
+    for (uint32_t idx = 0; idx < 100U; idx++) {
+        Mint_Loggo_Log("socket", MINT_LOGGO_LEVEL_INFO, "through the socket");
+    }
+    Mint_Loggo_DeleteLogger("socket");
+    Mint_Loggo_SocketFlush(sink);
+
+    size_t len = ReadQuiet(conn, buffer);
+    uint32_t lines = 0U;
+    for (size_t idx = 0U; idx < len; idx++) {
+        lines += buffer[idx] == '\n' ? 1U : 0U;
+    }
+    Expect(lines == 100U, "logger: every line arrives");
+    Expect(Mint_Loggo_SocketDropped(sink) == 0U, "logger: nothing dropped");
+
+    Mint_Loggo_SocketClose(sink);
+    close(conn);
+    StopListening(listener);
+}
+
+
+int main() {
+    snprintf(socket_path, sizeof(socket_path), "/tmp/loggo_socket_%d.sock", (int)getpid());
+    char* buffer = malloc(SOCKET_READ_MAX);
+    uint32_t* numbers = malloc(sizeof(uint32_t) * (SOCKET_READ_MAX / SOCKET_RECORD_SIZE));
+
+    TestBatching(buffer, numbers);
+    TestReconnect(buffer, numbers);
+    TestOverflow(MINT_LOGGO_OVERFLOW_DROP_NEWEST, 0U, "drop newest: keeps the first records, refuses the rest", buffer, numbers);
+    TestOverflow(MINT_LOGGO_OVERFLOW_DROP_OLDEST, 6U, "drop oldest: keeps the last records", buffer, numbers);
+    TestLogger(buffer);
+
+    free(numbers);
+    free(buffer);
+    printf("socket sink: %s\n", failures ? "FAILED" : "ok");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,219 @@
+// Many producers against many loggers while other loggers are created and deleted around them
+//
+// loggo_stress [-p producers] [-n messages]
+//   producers  threads logging, defaults to 8
+//   messages   per producer, spread over every logger, defaults to 20000
+//
+// Every logger writes into a checker instead of a sink. Each message carries its producer, stream
+// and sequence number and the checker wants exactly the next one, so a lost, doubled or reordered
+// message fails the run. INFO and ERROR are separate streams, lanes only keep order within a lane.
+// Queues are kept small so producers keep running into full queues.
+#define MINT_LOGGO_IMPLEMENTATION
+#include "mint_loggo.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#define STRESS_MAX_PRODUCERS 64U
+#define STRESS_STREAMS 2U
+#define STRESS_URGENT_EVERY 16U
+#define STRESS_CHURN_MAX 4096U
+
+typedef struct {
+    const char* name;
+    Mint_Loggo_LogFormat format;
+    uint32_t next[STRESS_MAX_PRODUCERS][STRESS_STREAMS];
+    uint32_t expected[STRESS_MAX_PRODUCERS][STRESS_STREAMS];
+    uint64_t errors;
+} Stress_Logger;
+
+static Stress_Logger loggers[] = {
+    {.name = "fifo", .format = {.level = MINT_LOGGO_LEVEL_DEBUG, .queue_capacity = 64U}},
+    {.name = "fifo.pooled", .format = {.level = MINT_LOGGO_LEVEL_DEBUG, .queue_capacity = 32U, .pool_slots = 16U}},
+    {.name = "lanes", .format = {.level = MINT_LOGGO_LEVEL_DEBUG, .queue_capacity = 64U, .priority = MINT_LOGGO_PRIORITY_LANES, .urgent_capacity = 8U}},
+    {.name = "sync", .format = {.level = MINT_LOGGO_LEVEL_DEBUG, .queue_capacity = 64U, .priority = MINT_LOGGO_PRIORITY_SYNC}},
+    {.name = "lazy", .format = {.level = MINT_LOGGO_LEVEL_DEBUG, .queue_capacity = 16U, .lazy = true}},
+    {.name = "threadless", .format = {.level = MINT_LOGGO_LEVEL_DEBUG, .queue_capacity = 64U, .threadless = true}},
+};
+
+#define STRESS_LOGGERS (sizeof(loggers) / sizeof(loggers[0]))
+
+static uint32_t producers = 8U;
+static uint32_t messages = 20000U;
+static uint32_t producers_done = 0U;
+static char* churn_names[STRESS_CHURN_MAX];
+static uint32_t churn_count = 0U;
+
+
+// Messages look like "#producer:stream:sequence;", whatever else the line holds is skipped
+static int CheckWrite(char* text, void* arg) {
+    Stress_Logger* logger = arg;
+    const char* mark = text;
+    while ((mark = strchr(mark, '#'))) {
+        unsigned producer = 0U;
+        unsigned stream = 0U;
+        unsigned sequence = 0U;
+        if (sscanf(mark, "#%u:%u:%u;", &producer, &stream, &sequence) != 3 || producer >= producers || stream >= STRESS_STREAMS) {
+            fprintf(stderr, "%s: unreadable line %s", logger->name, text);
+            logger->errors++;
+        } else if (sequence != logger->next[producer][stream]) {
+            if (logger->errors < 10U) {
+                fprintf(stderr, "%s: producer %u stream %u wanted %u got %u\n", logger->name, producer, stream, logger->next[producer][stream], sequence);
+            }
+            logger->errors++;
+            logger->next[producer][stream] = sequence + 1U;
+        } else {
+            logger->next[producer][stream]++;
+        }
+        mark++;
+    }
+    return 0;
+}
+
+
+static int CheckFlush(void* arg) {
+    (void)arg;
+    return 0;
+}
+
+
+static void* Produce(void* arg) {
+    uint32_t producer = (uint32_t)(uintptr_t)arg;
+    uint32_t sequence[STRESS_LOGGERS][STRESS_STREAMS] = {{0U}};
+    char text[64U];
+
+    for (uint32_t idx = 0; idx < messages; idx++) {
+        uint32_t target = (idx + producer) % STRESS_LOGGERS;
+        uint32_t stream = idx % STRESS_URGENT_EVERY == 0U ? 1U : 0U;
+        snprintf(text, sizeof(text), "#%u:%u:%u;", producer, stream, sequence[target][stream]++);
+        Mint_Loggo_Log(loggers[target].name, stream ? MINT_LOGGO_LEVEL_ERROR : MINT_LOGGO_LEVEL_INFO, text);
+    }
+
+    MINT_LOGGO_ATOMIC_ADD(&producers_done, 1U);
+    return NULL;
+}
+
+
+// Grows, fills with tombstones and rehashes the table while the producers look their loggers up
+static void* Churn(void* arg) {
+    (void)arg;
+    while (MINT_LOGGO_ATOMIC_LOAD(&producers_done) < producers && churn_count + 2U < STRESS_CHURN_MAX) {
+        // Names are borrowed by the logger so every one lives until the end
+        char* parent = malloc(32U);
+        char* child = malloc(40U);
+        snprintf(parent, 32U, "churn%u", churn_count);
+        snprintf(child, 40U, "churn%u.child", churn_count);
+        churn_names[churn_count++] = parent;
+        churn_names[churn_count++] = child;
+
+        Mint_Loggo_CreateLogger(parent, &(Mint_Loggo_LogFormat){.level = MINT_LOGGO_LEVEL_DEBUG, .queue_capacity = 16U, .lazy = churn_count % 4U == 0U},
+            &(Mint_Loggo_LogHandler){.handle = stdout, .write_handler = Mint_Loggo_NullWrite});
+        Mint_Loggo_CreateChild(child);
+        Mint_Loggo_Log(child, MINT_LOGGO_LEVEL_DEBUG, "churn");
+        Mint_Loggo_SetLevel(parent, MINT_LOGGO_LEVEL_WARN);
+
+        // Keep a few around so the table holds more than the stable loggers
+        if (churn_count >= 16U) {
+            Mint_Loggo_DeleteLogger(churn_names[churn_count - 16U]);
+        }
+    }
+    return NULL;
+}
+
+
+static void* PollThreadless(void* arg) {
+    (void)arg;
+    while (MINT_LOGGO_ATOMIC_LOAD(&producers_done) < producers) {
+        if (!Mint_Loggo_Poll(256U)) {
+            MINT_LOGGO_THREAD_YIELD();
+        }
+    }
+    return NULL;
+}
+
+
+int main(int argc, char** argv) {
+    for (int idx = 1; idx < argc; idx++) {
+        if (strcmp(argv[idx], "-p") == 0 && idx + 1 < argc) {
+            producers = (uint32_t)strtoul(argv[++idx], NULL, 10);
+        } else if (strcmp(argv[idx], "-n") == 0 && idx + 1 < argc) {
+            messages = (uint32_t)strtoul(argv[++idx], NULL, 10);
+        } else {
+            fprintf(stderr, "usage: loggo_stress [-p producers] [-n messages]\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (producers == 0U || producers > STRESS_MAX_PRODUCERS) {
+        fprintf(stderr, "producers must be 1 to %u\n", STRESS_MAX_PRODUCERS);
+        return EXIT_FAILURE;
+    }
+
+    for (uint32_t idx = 0; idx < STRESS_LOGGERS; idx++) {
+        Mint_Loggo_LogHandler handler = {.handle = &loggers[idx], .write_handler = CheckWrite, .flush_handler = CheckFlush};
+        if (Mint_Loggo_CreateLogger(loggers[idx].name, &loggers[idx].format, &handler) == -1) {
+            fprintf(stderr, "Could not create %s\n", loggers[idx].name);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // What every producer sends where, worked out the same way Produce does it
+    for (uint32_t producer = 0; producer < producers; producer++) {
+        for (uint32_t idx = 0; idx < messages; idx++) {
+            uint32_t stream = idx % STRESS_URGENT_EVERY == 0U ? 1U : 0U;
+            loggers[(idx + producer) % STRESS_LOGGERS].expected[producer][stream]++;
+        }
+    }
+
+    pthread_t threads[STRESS_MAX_PRODUCERS];
+    pthread_t churn;
+    pthread_t poller;
+    pthread_create(&churn, NULL, Churn, NULL);
+    pthread_create(&poller, NULL, PollThreadless, NULL);
+    for (uint32_t producer = 0; producer < producers; producer++) {
+        pthread_create(&threads[producer], NULL, Produce, (void*)(uintptr_t)producer);
+    }
+    for (uint32_t producer = 0; producer < producers; producer++) {
+        pthread_join(threads[producer], NULL);
+    }
+    pthread_join(churn, NULL);
+    pthread_join(poller, NULL);
+
+    // No deadline, every queued message has to come out
+    uint64_t dropped = Mint_Loggo_Shutdown(0U);
+
+    int result = EXIT_SUCCESS;
+    if (dropped) {
+        fprintf(stderr, "Shutdown dropped %llu messages\n", (unsigned long long)dropped);
+        result = EXIT_FAILURE;
+    }
+
+    for (uint32_t idx = 0; idx < STRESS_LOGGERS; idx++) {
+        Stress_Logger* logger = &loggers[idx];
+        for (uint32_t producer = 0; producer < producers; producer++) {
+            for (uint32_t stream = 0; stream < STRESS_STREAMS; stream++) {
+                if (logger->next[producer][stream] != logger->expected[producer][stream]) {
+                    fprintf(stderr, "%s: producer %u stream %u delivered %u of %u\n", logger->name, producer, stream,
+                            logger->next[producer][stream], logger->expected[producer][stream]);
+                    result = EXIT_FAILURE;
+                }
+            }
+        }
+        if (logger->errors) {
+            fprintf(stderr, "%s: %llu messages out of order or doubled\n", logger->name, (unsigned long long)logger->errors);
+            result = EXIT_FAILURE;
+        }
+    }
+
+    for (uint32_t idx = 0; idx < churn_count; idx++) {
+        free(churn_names[idx]);
+    }
+
+    printf("%u producers, %u messages each, %u loggers churned: %s\n", producers, messages, churn_count / 2U,
+           result == EXIT_SUCCESS ? "ok" : "FAILED");
+    return result;
+}
@@ -0,0 +1,175 @@
+// Throughput and ratio of the LZ block codec, then the file sink with and without compression
+//
+// loggo_lz_bench [-b block_size] [-n messages] [file]
+//   file       sample to compress, defaults to generated log lines
+//   messages   records pushed through each sink, defaults to 1000000
+//
+// The sink runs write loggo_bench.log (and its index) in the working directory and remove them after.
+#define _FILE_OFFSET_BITS 64
+#define MINT_LOGGO_IMPLEMENTATION
+#include "mint_loggo.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#define BENCH_SAMPLE_SIZE (32U * 1024U * 1024U)
+#define BENCH_LOG "loggo_bench.log"
+
+
+static double Seconds() {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+
+// Log shaped text, the same handful of messages with changing numbers
+static char* GenerateSample(size_t* len) {
+    static const char* const templates[] = {
+        "[LOG APP] [2024-05-01 12:%02u:%02u.%03u] INFO request id=%u path=/api/v1/items status=200 bytes=%u\n",
+        "[LOG APP] [2024-05-01 12:%02u:%02u.%03u] DEBUG cache lookup key=item:%u hit=true age_ms=%u\n",
+        "[LOG APP] [2024-05-01 12:%02u:%02u.%03u] WARN slow query table=orders rows=%u took_ms=%u\n",
+        "[LOG APP] [2024-05-01 12:%02u:%02u.%03u] ERROR upstream timeout host=10.0.%u.%u retrying\n",
+    };
+
+    char* sample = malloc(BENCH_SAMPLE_SIZE + 256U);
+    size_t used = 0U;
+    uint32_t seed = 12345U;
+    for (uint32_t idx = 0; used < BENCH_SAMPLE_SIZE; idx++) {
+        seed = seed * 1103515245U + 12345U;
+        const char* line = templates[(seed >> 16) % 4U];
+        used += (size_t)sprintf(sample + used, line, (idx / 60000U) % 60U, (idx / 1000U) % 60U, idx % 1000U, seed % 100000U, (seed >> 8) % 4096U);
+    }
+    *len = used;
+    return sample;
+}
+
+
+static char* ReadSample(const char* path, size_t* len) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Could not open %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    char* sample = malloc(BENCH_SAMPLE_SIZE);
+    *len = fread(sample, 1U, BENCH_SAMPLE_SIZE, file);
+    fclose(file);
+    return sample;
+}
+
+
+// Compress and decompress the sample block by block, checking the round trip
+static void BenchCodec(const char* sample, size_t len, size_t block_size) {
+    uint32_t* table = malloc(sizeof(uint32_t) * MINT_LOGGO_LZ_TABLE_SIZE);
+    char* packed = malloc(Mint_Loggo_LZBound(len) + (len / block_size + 1U) * 16U);
+    size_t* packed_lens = malloc(sizeof(size_t) * (len / block_size + 1U));
+    char* restored = malloc(len);
+
+    double start = Seconds();
+    size_t packed_total = 0U;
+    size_t blocks = 0U;
+    for (size_t pos = 0U; pos < len; pos += block_size, blocks++) {
+        size_t block = len - pos < block_size ? len - pos : block_size;
+        packed_lens[blocks] = Mint_Loggo_LZCompress(sample + pos, block, packed + packed_total, table);
+        packed_total += packed_lens[blocks];
+    }
+    double compress_time = Seconds() - start;
+
+    start = Seconds();
+    size_t packed_pos = 0U;
+    for (size_t pos = 0U, idx = 0U; idx < blocks; pos += block_size, idx++) {
+        size_t block = len - pos < block_size ? len - pos : block_size;
+        if (Mint_Loggo_LZDecompress(packed + packed_pos, packed_lens[idx], restored + pos, block) != block) {
+            fprintf(stderr, "Block %zu did not decode\n", idx);
+            exit(EXIT_FAILURE);
+        }
+        packed_pos += packed_lens[idx];
+    }
+    double decompress_time = Seconds() - start;
+
+    if (memcmp(sample, restored, len) != 0) {
+        fprintf(stderr, "Round trip mismatch\n");
+        exit(EXIT_FAILURE);
+    }
+
+    double megabytes = (double)len / (1024.0 * 1024.0);
+    printf("codec   %zu KB blocks: ratio %.2fx, compress %.0f MB/s, decompress %.0f MB/s\n",
+           block_size / 1024U, (double)len / (double)packed_total,
+           megabytes / (compress_time > 0.0 ? compress_time : 0.001), megabytes / (decompress_time > 0.0 ? decompress_time : 0.001));
+
+    free(table);
+    free(packed);
+    free(packed_lens);
+    free(restored);
+}
+
+
+// Push messages through a file sink and time it until everything is on disk
+static void BenchSink(const char* name, Mint_Loggo_Compression compression, size_t block_size, uint32_t messages) {
+    Mint_Loggo_FileSink* sink = Mint_Loggo_FileOpen(&(Mint_Loggo_FileConfig){.path=BENCH_LOG, .compression=compression, .block_size=(uint32_t)block_size});
+    if (!sink) {
+        fprintf(stderr, "Could not open %s\n", BENCH_LOG);
+        exit(EXIT_FAILURE);
+    }
+
+    Mint_Loggo_CreateLogger(name,
+        &(Mint_Loggo_LogFormat){.level=MINT_LOGGO_LEVEL_DEBUG, .linebeg="[LOG BENCH]", .queue_capacity=65536U, .time_precision=MINT_LOGGO_PRECISION_MICROS},
+        &(Mint_Loggo_LogHandler){.handle=sink, .write_handler=Mint_Loggo_FileWrite, .close_handler=Mint_Loggo_FileClose, .flush_handler=Mint_Loggo_FileFlush});
+
+    char text[128U];
+    double start = Seconds();
+    for (uint32_t idx = 0; idx < messages; idx++) {
+        snprintf(text, sizeof(text), "request id=%u path=/api/v1/items status=200 bytes=%u", idx, idx % 4096U);
+        Mint_Loggo_Log(name, (Mint_Loggo_LogLevel)(idx % 4U), text);
+    }
+    Mint_Loggo_DeleteLogger(name);
+    Mint_Loggo_FileClose(sink);
+    double elapsed = Seconds() - start;
+
+    FILE* file = fopen(BENCH_LOG, "rb");
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    remove(BENCH_LOG);
+    remove(BENCH_LOG ".idx");
+
+    printf("sink    %-5s %u messages in %.2fs (%.0f k msg/s), %.1f MB on disk\n",
+           name, messages, elapsed, (double)messages / (elapsed > 0.0 ? elapsed : 0.001) / 1000.0, (double)size / (1024.0 * 1024.0));
+}
+
+
+int main(int argc, char** argv) {
+    size_t block_size = MINT_LOGGO_DEFAULT_BLOCK_SIZE;
+    uint32_t messages = 1000000U;
+    const char* path = NULL;
+
+    for (int idx = 1; idx < argc; idx++) {
+        if (strcmp(argv[idx], "-b") == 0 && idx + 1 < argc) {
+            block_size = (size_t)strtoul(argv[++idx], NULL, 10);
+        } else if (strcmp(argv[idx], "-n") == 0 && idx + 1 < argc) {
+            messages = (uint32_t)strtoul(argv[++idx], NULL, 10);
+        } else if (argv[idx][0] != '-' && !path) {
+            path = argv[idx];
+        } else {
+            fprintf(stderr, "usage: loggo_lz_bench [-b block_size] [-n messages] [file]\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (block_size == 0U) {
+        block_size = MINT_LOGGO_DEFAULT_BLOCK_SIZE;
+    }
+
+    size_t len = 0U;
+    char* sample = path ? ReadSample(path, &len) : GenerateSample(&len);
+    BenchCodec(sample, len, block_size);
+    free(sample);
+
+    BenchSink("plain", MINT_LOGGO_COMPRESSION_NONE, block_size, messages);
+    BenchSink("lz", MINT_LOGGO_COMPRESSION_LZ, block_size, messages);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,265 @@
+// Pull a time range and/or level out of a log written by the file sink without reading all of it
+//
+// loggo_query [-f from] [-t to] [-l level] [-i index] [-v] file.log
+//   from/to  unix seconds, fractions are fine
+//   level    DEBUG, INFO, WARN, ERROR or FATAL, records below it are left out
+//   index    defaults to file.log.idx
+//   -v       print how much of the log was read to stderr
+//
+// Chunks are picked from the index, time bounds are applied per chunk and levels per line.
+// Whatever was written after the last index entry (a crash, or a logger still running) is scanned.
+// Compressed logs are decoded one frame at a time, each index entry covers exactly one frame.
+#define _FILE_OFFSET_BITS 64
+#define MINT_LOGGO_IMPLEMENTATION
+#include "mint_loggo.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(_WIN32)
+    #define LOGGO_QUERY_SEEK(file, offset) _fseeki64((file), (__int64)(offset), SEEK_SET)
+    #define LOGGO_QUERY_TELL(file) ((uint64_t)_ftelli64((file)))
+#else
+    #define LOGGO_QUERY_SEEK(file, offset) fseeko((file), (off_t)(offset), SEEK_SET)
+    #define LOGGO_QUERY_TELL(file) ((uint64_t)ftello((file)))
+#endif
+
+#define LOGGO_QUERY_LEVELS (MINT_LOGGO_LEVEL_FATAL + 1)
+
+static const char* const level_names[LOGGO_QUERY_LEVELS] = {"DEBUG", "INFO", "WARN", "ERROR", "FATAL"};
+
+typedef struct {
+    uint64_t from_ns;
+    uint64_t to_ns;
+    int32_t level;
+    bool verbose;
+    bool compressed;
+    uint64_t bytes_read;
+    uint64_t chunks_read;
+} Loggo_Query;
+
+
+static void Usage() {
+    fprintf(stderr, "usage: loggo_query [-f from] [-t to] [-l level] [-i index] [-v] file.log\n");
+    exit(EXIT_FAILURE);
+}
+
+
+// Nothing useful can be printed without the memory, so running out stops the query
+static void* Reallocate(void* memory, size_t size) {
+    void* grown = realloc(memory, size ? size : 1U);
+    if (!grown) {
+        fprintf(stderr, "Out of memory reading %zu bytes\n", size);
+        free(memory);
+        exit(EXIT_FAILURE);
+    }
+    return grown;
+}
+
+
+static int32_t ParseLevel(const char* name) {
+    for (int32_t level = 0; level < LOGGO_QUERY_LEVELS; level++) {
+        if (strcmp(name, level_names[level]) == 0) {
+            return level;
+        }
+    }
+
+    fprintf(stderr, "Unknown level: %s\n", name);
+    exit(EXIT_FAILURE);
+}
+
+
+static bool Contains(const char* line, size_t len, const char* tag) {
+    size_t tag_len = strlen(tag);
+    for (size_t idx = 0; idx + tag_len <= len; idx++) {
+        if (memcmp(line + idx, tag, tag_len) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// Text lines carry "] LEVEL ", JSON lines "\"level\":\"LEVEL\""
+static bool LineMatches(const Loggo_Query* query, const char* line, size_t len) {
+    if (query->level == MINT_LOGGO_LEVEL_DEBUG) {
+        return true;
+    }
+
+    char text_tag[32U];
+    char json_tag[32U];
+    for (int32_t level = query->level; level < LOGGO_QUERY_LEVELS; level++) {
+        snprintf(text_tag, sizeof(text_tag), "] %s ", level_names[level]);
+        snprintf(json_tag, sizeof(json_tag), "\"level\":\"%s\"", level_names[level]);
+        if (Contains(line, len, text_tag) || Contains(line, len, json_tag)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// Decode whole frames in place of the raw bytes, a torn frame at the end is reported and dropped
+static char* DecodeFrames(char* raw, size_t* len) {
+    size_t decoded_len = 0U;
+    char* decoded = NULL;
+    size_t pos = 0U;
+
+    while (pos + sizeof(Mint_Loggo_FrameHeader) <= *len) {
+        Mint_Loggo_FrameHeader header;
+        memcpy(&header, raw + pos, sizeof(header));
+        pos += sizeof(header);
+
+        // A stored frame is its raw bytes, any other length means the header is corrupt
+        bool stored = (header.flags & MINT_LOGGO_FRAME_STORED) != 0U;
+        if (header.magic != MINT_LOGGO_FRAME_MAGIC || header.stored_len > *len - pos || (stored && header.raw_len != header.stored_len)) {
+            fprintf(stderr, "Stopped at a torn or corrupt frame\n");
+            break;
+        }
+
+        decoded = Reallocate(decoded, decoded_len + header.raw_len);
+        size_t got = header.raw_len;
+        if (stored) {
+            memcpy(decoded + decoded_len, raw + pos, header.raw_len);
+        } else {
+            got = Mint_Loggo_LZDecompress(raw + pos, header.stored_len, decoded + decoded_len, header.raw_len);
+        }
+        if (got != header.raw_len) {
+            fprintf(stderr, "Stopped at a torn or corrupt frame\n");
+            break;
+        }
+        decoded_len += got;
+        pos += header.stored_len;
+    }
+
+    free(raw);
+    *len = decoded_len;
+    return decoded;
+}
+
+
+// Read [offset, offset + length) and print the lines that pass the level filter
+static void EmitRange(Loggo_Query* query, FILE* log, uint64_t offset, uint64_t length) {
+    if (length == 0 || LOGGO_QUERY_SEEK(log, offset) != 0) {
+        return;
+    }
+
+    char* buffer = Reallocate(NULL, (size_t)length);
+    size_t got = fread(buffer, 1U, (size_t)length, log);
+    query->bytes_read += got;
+    query->chunks_read++;
+
+    if (query->compressed) {
+        buffer = DecodeFrames(buffer, &got);
+    }
+
+    size_t start = 0U;
+    while (start < got) {
+        char* newline = memchr(buffer + start, '\n', got - start);
+        size_t end = newline ? (size_t)(newline - buffer) + 1U : got;
+        if (LineMatches(query, buffer + start, end - start)) {
+            fwrite(buffer + start, 1U, end - start, stdout);
+        }
+        start = end;
+    }
+    free(buffer);
+}
+
+
+// A chunk is worth reading if its time range overlaps and it holds a record at or above the level
+static bool ChunkMatches(const Loggo_Query* query, const Mint_Loggo_IndexEntry* entry) {
+    if (entry->last_ns < query->from_ns || entry->first_ns > query->to_ns) {
+        return false;
+    }
+
+    uint32_t wanted = entry->counts[MINT_LOGGO_LEVEL_FATAL + 1];
+    for (int32_t level = query->level; level < LOGGO_QUERY_LEVELS; level++) {
+        wanted += entry->counts[level];
+    }
+    return wanted > 0U;
+}
+
+
+int main(int argc, char** argv) {
+    Loggo_Query query = {.from_ns = 0U, .to_ns = UINT64_MAX, .level = MINT_LOGGO_LEVEL_DEBUG};
+    const char* index_path = NULL;
+    const char* log_path = NULL;
+
+    for (int idx = 1; idx < argc; idx++) {
+        bool has_value = idx + 1 < argc;
+        if (strcmp(argv[idx], "-f") == 0 && has_value) {
+            query.from_ns = (uint64_t)(strtod(argv[++idx], NULL) * 1e9);
+        } else if (strcmp(argv[idx], "-t") == 0 && has_value) {
+            query.to_ns = (uint64_t)(strtod(argv[++idx], NULL) * 1e9);
+        } else if (strcmp(argv[idx], "-l") == 0 && has_value) {
+            query.level = ParseLevel(argv[++idx]);
+        } else if (strcmp(argv[idx], "-i") == 0 && has_value) {
+            index_path = argv[++idx];
+        } else if (strcmp(argv[idx], "-v") == 0) {
+            query.verbose = true;
+        } else if (argv[idx][0] != '-' && !log_path) {
+            log_path = argv[idx];
+        } else {
+            Usage();
+        }
+    }
+
+    if (!log_path) {
+        Usage();
+    }
+
+    FILE* log = fopen(log_path, "rb");
+    if (!log) {
+        fprintf(stderr, "Could not open %s\n", log_path);
+        return EXIT_FAILURE;
+    }
+
+    uint32_t magic_word = 0U;
+    query.compressed = fread(&magic_word, sizeof(magic_word), 1U, log) == 1U && magic_word == MINT_LOGGO_FRAME_MAGIC;
+
+    char default_index[4096U];
+    if (!index_path) {
+        snprintf(default_index, sizeof(default_index), "%s.idx", log_path);
+        index_path = default_index;
+    }
+
+    FILE* index = fopen(index_path, "rb");
+    char magic[8U];
+    size_t magic_len = strlen(MINT_LOGGO_INDEX_MAGIC);
+    if (!index || fread(magic, 1U, magic_len, index) != magic_len || memcmp(magic, MINT_LOGGO_INDEX_MAGIC, magic_len) != 0) {
+        fprintf(stderr, "Could not read index %s\n", index_path);
+        fclose(log);
+        return EXIT_FAILURE;
+    }
+
+    // Entries are in file order so the unindexed tail starts where the last one ends
+    Mint_Loggo_IndexEntry entry;
+    uint64_t indexed_end = 0U;
+    uint64_t newest_ns = 0U;
+    while (fread(&entry, sizeof(entry), 1U, index) == 1U) {
+        if (ChunkMatches(&query, &entry)) {
+            EmitRange(&query, log, entry.offset, entry.length);
+        }
+        indexed_end = entry.offset + entry.length;
+        newest_ns = entry.last_ns > newest_ns ? entry.last_ns : newest_ns;
+    }
+
+    // The tail is newer than anything indexed
+    fseek(log, 0, SEEK_END);
+    uint64_t log_size = LOGGO_QUERY_TELL(log);
+    if (log_size > indexed_end && query.to_ns >= newest_ns) {
+        EmitRange(&query, log, indexed_end, log_size - indexed_end);
+    }
+
+    if (query.verbose) {
+        fprintf(stderr, "read %llu of %llu bytes in %llu chunks\n",
+                (unsigned long long)query.bytes_read, (unsigned long long)log_size, (unsigned long long)query.chunks_read);
+    }
+
+    fclose(index);
+    fclose(log);
+    return EXIT_SUCCESS;
+}
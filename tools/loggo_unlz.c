@@ -0,0 +1,90 @@
+// Decompress a log written by a compressed file sink
+//
+// loggo_unlz file.log [out]
+//   out defaults to stdout
+//
+// Frames are decoded one at a time, a torn frame at the end (the block a crashed writer was filling)
+// is reported and everything before it is kept.
+#define _FILE_OFFSET_BITS 64
+#define MINT_LOGGO_IMPLEMENTATION
+#include "mint_loggo.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "usage: loggo_unlz file.log [out]\n");
+        return EXIT_FAILURE;
+    }
+
+    FILE* in = fopen(argv[1], "rb");
+    if (!in) {
+        fprintf(stderr, "Could not open %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    FILE* out = argc == 3 ? fopen(argv[2], "wb") : stdout;
+    if (!out) {
+        fprintf(stderr, "Could not open %s\n", argv[2]);
+        fclose(in);
+        return EXIT_FAILURE;
+    }
+
+    char* stored = NULL;
+    char* raw = NULL;
+    size_t stored_capacity = 0U;
+    size_t raw_capacity = 0U;
+    uint64_t frames = 0U;
+    int result = EXIT_SUCCESS;
+
+    Mint_Loggo_FrameHeader header;
+    while (fread(&header, sizeof(header), 1U, in) == 1U) {
+        if (header.magic != MINT_LOGGO_FRAME_MAGIC) {
+            fprintf(stderr, "Bad frame magic after %llu frames\n", (unsigned long long)frames);
+            result = EXIT_FAILURE;
+            break;
+        }
+
+        if (header.stored_len > stored_capacity) {
+            stored_capacity = header.stored_len;
+            stored = realloc(stored, stored_capacity);
+        }
+        if (header.raw_len > raw_capacity) {
+            raw_capacity = header.raw_len;
+            raw = realloc(raw, raw_capacity);
+        }
+
+        if (fread(stored, 1U, header.stored_len, in) != header.stored_len) {
+            fprintf(stderr, "Torn frame after %llu frames, the rest of the log is lost\n", (unsigned long long)frames);
+            result = EXIT_FAILURE;
+            break;
+        }
+
+        const char* text = stored;
+        size_t len = header.stored_len;
+        if (!(header.flags & MINT_LOGGO_FRAME_STORED)) {
+            len = Mint_Loggo_LZDecompress(stored, header.stored_len, raw, header.raw_len);
+            text = raw;
+        }
+        if (len != header.raw_len) {
+            fprintf(stderr, "Corrupt frame after %llu frames\n", (unsigned long long)frames);
+            result = EXIT_FAILURE;
+            break;
+        }
+
+        fwrite(text, 1U, len, out);
+        frames++;
+    }
+
+    free(stored);
+    free(raw);
+    fclose(in);
+    if (out != stdout) {
+        fclose(out);
+    }
+    return result;
+}